@@ -0,0 +1,322 @@
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+                 rf_mtr RESOURCE LOAD THROUGHPUT BENCHMARK
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    DESCRIPTION
+
+        Generates synthetic file sets and loads them through
+        rf_mtr with different loader thread counts, reporting
+        files/s, MB/s, time-to-first-resource and the loader
+        threads' CPU usage for each run (the main thread
+        sleeps until resources finish, and its own CPU time
+        is left out).
+
+        File sets:
+
+            small   many small files
+            large   a few large files
+            mixed   both of the above
+
+        Every configuration is run with a warm page cache
+        (files were just read) and a cold one (every file is
+        dropped from the page cache with posix_fadvise before
+        the run, which doesn't need root).
+
+    BUILDING
+
+        g++ -O2 -I.. rf_mtr_bench.cpp -o rf_mtr_bench -lpthread
+
+    USAGE
+
+        rf_mtr_bench [directory] [scale]
+
+        directory   where the file sets are generated
+                    (default: /tmp/rf_mtr_bench)
+        scale       multiplies the number of files in
+                    each set (default: 1)
+
+    LICENSE INFORMATION IS AT THE END OF THE FILE
+*/
+
+// the largest configuration below loads with 8 threads
+#define RF_MTR_MAX_THREADS 8
+#include "../rf_mtr.h"
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+typedef struct FileSet {
+    const char *name;
+    uint32_t small_count;
+    int64_t small_size;
+    uint32_t large_count;
+    int64_t large_size;
+} FileSet;
+
+typedef struct BenchResult {
+    double seconds,
+           first_seconds,
+           cpu_seconds;
+    int64_t bytes;
+    uint32_t files;
+} BenchResult;
+
+typedef struct BenchRun {
+    pthread_mutex_t mutex;
+    pthread_cond_t done;
+    double start;
+    BenchResult result;
+} BenchRun;
+
+static double time_seconds(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static double cpu_seconds(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+           usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+static double thread_cpu_seconds(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static int write_file(const char *filename, int64_t size) {
+    FILE *file = fopen(filename, "wb");
+    if(!file) {
+        return 0;
+    }
+
+    char chunk[4096];
+    for(int i = 0; i < (int)sizeof(chunk); i++) {
+        chunk[i] = (char)(i * 31);
+    }
+    while(size > 0) {
+        size_t n = size > (int64_t)sizeof(chunk) ? sizeof(chunk) : (size_t)size;
+        fwrite(chunk, n, 1, file);
+        size -= n;
+    }
+    fclose(file);
+    return 1;
+}
+
+static char **generate_set(const char *directory, FileSet *set, uint32_t *count) {
+    *count = set->small_count + set->large_count;
+    char **filenames = (char **)calloc(*count, sizeof(char *));
+
+    for(uint32_t i = 0; i < *count; i++) {
+        int64_t size = i < set->small_count ? set->small_size : set->large_size;
+        filenames[i] = (char *)malloc(strlen(directory) + 64);
+        sprintf(filenames[i], "%s/%s_%u.bin", directory, set->name, i);
+
+        struct stat st;
+        if(stat(filenames[i], &st) || st.st_size != size) {
+            if(!write_file(filenames[i], size)) {
+                fprintf(stderr, "couldn't write %s\n", filenames[i]);
+                exit(1);
+            }
+        }
+    }
+
+    return filenames;
+}
+
+static void set_page_cache(char **filenames, uint32_t count, int8_t warm) {
+    for(uint32_t i = 0; i < count; i++) {
+        int fd = open(filenames[i], O_RDONLY);
+        if(fd < 0) {
+            continue;
+        }
+        if(warm) {
+            char buffer[65536];
+            while(read(fd, buffer, sizeof(buffer)) > 0);
+        }
+        else {
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        }
+        close(fd);
+    }
+}
+
+// called on a loader thread as each resource finishes
+static void resource_done(rf_ResourceMaster *r, uint16_t index, int8_t status, void *user_data) {
+    BenchRun *run = (BenchRun *)user_data;
+    void *data = NULL;
+    int64_t data_len = 0;
+    if(status == RF_MTR_STATUS_READY) {
+        rf_mtr_grab_resource_data(r, index, &data, &data_len);
+        free(data);
+    }
+
+    pthread_mutex_lock(&run->mutex);
+    if(run->result.first_seconds < 0) {
+        run->result.first_seconds = time_seconds() - run->start;
+    }
+    run->result.bytes += data_len;
+    ++run->result.files;
+    pthread_cond_signal(&run->done);
+    pthread_mutex_unlock(&run->mutex);
+}
+
+static void sleep_ms(long ms) {
+    struct timespec t = { ms / 1000, (ms % 1000) * 1000000 };
+    nanosleep(&t, NULL);
+}
+
+static BenchResult run(char **filenames, uint32_t count, uint8_t thread_count) {
+    BenchRun bench;
+    pthread_mutex_init(&bench.mutex, NULL);
+    pthread_cond_init(&bench.done, NULL);
+    BenchResult empty = { 0, -1, 0, 0, 0 };
+    bench.result = empty;
+    rf_MTRWaiter *waiters = (rf_MTRWaiter *)calloc(count, sizeof(rf_MTRWaiter));
+
+    rf_ResourceMaster r = rf_mtr_init((uint16_t)count, (const char **)filenames);
+    rf_mtr_set_thread_count(&r, thread_count);
+
+    double cpu_start = cpu_seconds(),
+           main_cpu_start = thread_cpu_seconds();
+    bench.start = time_seconds();
+
+    for(uint32_t i = 0; i < count; i++) {
+        rf_mtr_request(&r, (uint16_t)i);
+        waiters[i].func = resource_done;
+        waiters[i].user_data = &bench;
+        rf_mtr_wait(&r, (uint16_t)i, waiters + i);
+    }
+
+    // sleep until every resource has finished, waking now and then to let
+    // rf_mtr_update start or restart loading
+    rf_mtr_update(&r);
+    pthread_mutex_lock(&bench.mutex);
+    while(bench.result.files < count) {
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += 10 * 1000000;
+        if(until.tv_nsec >= 1000000000) {
+            until.tv_nsec -= 1000000000;
+            ++until.tv_sec;
+        }
+        if(pthread_cond_timedwait(&bench.done, &bench.mutex, &until) == ETIMEDOUT) {
+            pthread_mutex_unlock(&bench.mutex);
+            rf_mtr_update(&r);
+            pthread_mutex_lock(&bench.mutex);
+        }
+    }
+    BenchResult result = bench.result;
+    pthread_mutex_unlock(&bench.mutex);
+
+    result.seconds = time_seconds() - bench.start;
+
+    while(r.is_loading) {
+        rf_mtr_update(&r);
+        if(r.is_loading) {
+            sleep_ms(1);
+        }
+    }
+    result.cpu_seconds = (cpu_seconds() - cpu_start) - (thread_cpu_seconds() - main_cpu_start);
+
+    rf_mtr_clean_up(&r);
+    free(waiters);
+    pthread_cond_destroy(&bench.done);
+    pthread_mutex_destroy(&bench.mutex);
+    return result;
+}
+
+int main(int argc, char **argv) {
+    const char *directory = argc > 1 ? argv[1] : "/tmp/rf_mtr_bench";
+    uint32_t scale = argc > 2 ? (uint32_t)atoi(argv[2]) : 1;
+    if(!scale) {
+        scale = 1;
+    }
+
+    mkdir(directory, 0755);
+
+    FileSet sets[] = {
+        { "small", 4000 * scale, 4 * 1024,         0,         0 },
+        { "large", 0,            0,                8 * scale, 32 * 1024 * 1024 },
+        { "mixed", 2000 * scale, 4 * 1024,         4 * scale, 16 * 1024 * 1024 },
+    };
+    uint8_t thread_counts[] = { 1, 2, 4, 8 };
+
+    printf("%-6s %-5s %7s %10s %10s %10s %10s\n",
+           "set", "cache", "threads", "files/s", "MB/s", "first(ms)", "load cpu%");
+
+    for(uint32_t s = 0; s < sizeof(sets) / sizeof(sets[0]); s++) {
+        uint32_t count = 0;
+        char **filenames = generate_set(directory, sets + s, &count);
+        if(count > 65535) {
+            fprintf(stderr, "%s: too many files for rf_mtr (%u)\n", sets[s].name, count);
+            exit(1);
+        }
+
+        for(int8_t warm = 1; warm >= 0; warm--) {
+            for(uint32_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+                if(thread_counts[t] > RF_MTR_MAX_THREADS) {
+                    continue;
+                }
+
+                set_page_cache(filenames, count, warm);
+                BenchResult result = run(filenames, count, thread_counts[t]);
+
+                printf("%-6s %-5s %7u %10.0f %10.1f %10.3f %9.1f%%\n",
+                       sets[s].name, warm ? "warm" : "cold", thread_counts[t],
+                       result.files / result.seconds,
+                       result.bytes / (1024.0 * 1024.0) / result.seconds,
+                       result.first_seconds * 1000.0,
+                       100.0 * result.cpu_seconds / result.seconds);
+            }
+        }
+
+        for(uint32_t i = 0; i < count; i++) {
+            free(filenames[i]);
+        }
+        free(filenames);
+    }
+
+    return 0;
+}
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+MIT License
+
+Copyright (c) 2017 Ryan Fleury
+
+Permission is hereby granted, free of charge, to any
+person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the
+Software without restriction, including without
+limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software
+is furnished to do so, subject to the following
+conditions: The above copyright notice and this permission
+notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF
+ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
@@ -0,0 +1,359 @@
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+                   rf_ui HEADLESS FRAME BENCHMARK
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    DESCRIPTION
+
+        Replays a recorded input session (see RECORDING AND
+        REPLAY in rf_ui.h) against synthetic UIs of 1k to
+        100k widgets, without a window, and reports for each
+        run the CPU time per frame (mean, median, 99th
+        percentile and worst), how many allocations rf_ui made
+        per frame after the first one, and how many widgets
+        were processed per second.
+
+        UIs:
+
+            grid    every widget is submitted every frame
+                    (buttons, sliders, labels and the odd line
+                    edit, most of them off-screen)
+            list    the same number of rows in a virtualized
+                    rf_ui list, so only the visible rows are
+                    submitted
+
+        Every frame builds a draw list and its vertices too,
+        with fixed-width glyphs.
+
+    BUILDING
+
+        g++ -O2 -I.. rf_ui_bench.cpp -o rf_ui_bench
+
+    USAGE
+
+        rf_ui_bench [recording] [frames]
+
+        recording   a session saved with rf_ui_recording_save;
+                    if the file doesn't exist, a synthetic
+                    session (the cursor sweeping the screen,
+                    clicking, dragging, typing and scrolling)
+                    is generated and saved there, so later
+                    runs replay the same input
+                    (default: /tmp/rf_ui_bench.rfui)
+        frames      length of the synthetic session
+                    (default: 600)
+
+    LICENSE INFORMATION IS AT THE END OF THE FILE
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t alloc_count = 0;
+
+static void *bench_realloc(void *data, size_t size) {
+    ++alloc_count;
+    return realloc(data, size);
+}
+
+#define RF_UI_REALLOC bench_realloc
+#define RF_UI_IMPLEMENTATION
+#include "../rf_ui.h"
+
+#define SCREEN_W 1920
+#define SCREEN_H 1080
+#define CELL_W 120
+#define CELL_H 28
+#define COLUMNS (SCREEN_W / CELL_W)
+
+typedef struct BenchResult {
+    double mean_ms,
+           median_ms,
+           p99_ms,
+           max_ms,
+           allocs_per_frame,
+           widgets_per_second;
+} BenchResult;
+
+static double cpu_seconds(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a,
+           y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+static float glyph(void *user_data, uint32_t codepoint, float x, float y, float *quad, float *uv) {
+    (void)user_data;
+    if(codepoint > ' ') {
+        quad[0] = x;
+        quad[1] = y;
+        quad[2] = x + RF_UI_CHAR_WIDTH;
+        quad[3] = y + RF_UI_LINE_HEIGHT;
+        uv[0] = (codepoint % 16) / 16.0f;
+        uv[1] = (codepoint / 16 % 16) / 16.0f;
+        uv[2] = uv[0] + 1 / 16.0f;
+        uv[3] = uv[1] + 1 / 16.0f;
+    }
+    return RF_UI_CHAR_WIDTH;
+}
+
+// drives the input functions like a user would and records the result
+static void generate_session(rf_UIRecording *rec, uint32_t frames) {
+    rf_UIState ui = rf_ui_init();
+    uint32_t time = 0;
+    const char *typed = "hello, world ";
+
+    for(uint32_t f = 0; f < frames; f++) {
+        rf_ui_begin(&ui);
+
+        // a few cursor samples per frame, sweeping the screen
+        for(int i = 0; i < 3; i++) {
+            float t = (f * 3 + i) / 90.0f;
+            float x = SCREEN_W * (0.5f + 0.45f * (float)sin(t * 1.3)),
+                  y = SCREEN_H * (0.5f + 0.45f * (float)sin(t * 0.7));
+            rf_ui_input_cursor(&ui, x, y, time += 5);
+        }
+
+        uint32_t phase = f % 120;
+        if(phase == 10 || phase == 50) {
+            rf_ui_input_control(&ui, RF_UI_CONTROL_LEFT_MOUSE, 1, time += 1);
+        }
+        if(phase == 12 || phase == 80) {
+            rf_ui_input_control(&ui, RF_UI_CONTROL_LEFT_MOUSE, 0, time += 1);
+        }
+        if(phase >= 14 && phase < 14 + strlen(typed)) {
+            rf_ui_input_text(&ui, (uint8_t)typed[phase - 14], time += 1);
+        }
+        if(phase == 30) {
+            rf_ui_input_control(&ui, RF_UI_CONTROL_BACKSPACE, 1, time += 1);
+            rf_ui_input_control(&ui, RF_UI_CONTROL_BACKSPACE, 0, time += 1);
+        }
+        if(phase >= 90 && phase < 110) {
+            rf_ui_input_scroll(&ui, phase < 100 ? 40.0f : -40.0f, time += 1);
+        }
+        if(phase == 115) {
+            rf_ui_input_control(&ui, RF_UI_CONTROL_DOWN_PRESS, 1, time += 1);
+            rf_ui_input_control(&ui, RF_UI_CONTROL_DOWN_PRESS, 0, time += 1);
+        }
+
+        rf_ui_record_frame(&ui, rec);
+        rf_ui_end(&ui);
+        time += 16;
+    }
+
+    rf_ui_clean_up(&ui);
+}
+
+static int load_session(const char *filename, rf_UIRecording *rec) {
+    FILE *file = fopen(filename, "rb");
+    if(!file) {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    void *data = malloc(size > 0 ? size : 1);
+    size_t read = fread(data, 1, size, file);
+    fclose(file);
+
+    int loaded = size > 0 && read == (size_t)size && rf_ui_recording_load(rec, data, (uint32_t)size);
+    free(data);
+    return loaded;
+}
+
+static void save_session(const char *filename, rf_UIRecording *rec) {
+    void *data = NULL;
+    uint32_t size = rf_ui_recording_save(rec, &data);
+    FILE *file = fopen(filename, "wb");
+    if(file) {
+        fwrite(data, 1, size, file);
+        fclose(file);
+    }
+    RF_UI_FREE(data);
+}
+
+static uint32_t grid_ui(rf_UIState *ui, uint32_t widget_count, float *values, char (*edits)[32], float scroll) {
+    uint32_t edit = 0;
+    for(uint32_t i = 0; i < widget_count; i++) {
+        float x = (float)(i % COLUMNS) * CELL_W + 2,
+              y = (float)(i / COLUMNS) * CELL_H + 2 - scroll;
+        rf_ui_id id = rf_ui_get_id_int(ui, i);
+        switch(i % 8) {
+            case 0: case 1: case 2:
+                rf_button(ui, id, x, y, CELL_W - 4, CELL_H - 4);
+                break;
+            case 3: case 4:
+                values[i] = rf_slider(ui, id, x, y, CELL_W - 4, CELL_H - 4, values[i]);
+                break;
+            case 5: case 6:
+                rf_ui_draw_text(ui, x, y + 4, "Label", 0xffffffff);
+                break;
+            default:
+                if(i % 64 == 7) {
+                    rf_line_edit(ui, id, x, y, CELL_W - 4, CELL_H - 4, edits[edit++], 32);
+                }
+                else {
+                    rf_button(ui, id, x, y, CELL_W - 4, CELL_H - 4);
+                }
+                break;
+        }
+    }
+    return widget_count;
+}
+
+static uint32_t list_ui(rf_UIState *ui, uint32_t widget_count, float *values) {
+    rf_UIListView view;
+    uint32_t submitted = 0;
+    if(rf_ui_list_begin(ui, rf_ui_get_id(ui, "list"), 0, 0, SCREEN_W, SCREEN_H,
+                        widget_count, CELL_H, &view)) {
+        for(uint32_t i = view.first; i < view.last; i++) {
+            rf_UIRect r = rf_ui_list_row(ui, &view, i);
+            rf_ui_id id = rf_ui_get_id_int(ui, i);
+            if(i % 2) {
+                values[i] = rf_slider(ui, id, r.x, r.y, r.w / 2, r.h, values[i]);
+            }
+            else {
+                rf_button(ui, id, r.x, r.y, r.w / 2, r.h);
+            }
+            rf_ui_draw_text(ui, r.x + r.w / 2 + 8, r.y + 4, "Row", 0xffffffff);
+            ++submitted;
+        }
+    }
+    rf_ui_list_end(ui, &view);
+    return submitted;
+}
+
+static BenchResult run(rf_UIRecording *rec, uint32_t widget_count, int list) {
+    BenchResult result;
+    rf_UIState ui = rf_ui_init();
+    rf_UIDrawList draw_list = rf_ui_draw_list_init();
+    rf_ui_set_draw_list(&ui, &draw_list);
+
+    float *values = (float *)calloc(widget_count, sizeof(float));
+    char (*edits)[32] = (char (*)[32])calloc(widget_count / 64 + 1, 32);
+    double *frame_ms = (double *)malloc(rec->frame_count * sizeof(double));
+    uint64_t steady_allocs = 0,
+             widgets = 0;
+    double total = 0;
+    float scroll = 0;
+
+    for(uint32_t f = 0; f < rec->frame_count; f++) {
+        uint64_t allocs = alloc_count;
+        double start = cpu_seconds();
+
+        rf_ui_begin(&ui);
+        rf_ui_replay_frame(&ui, rec, f);
+        scroll += ui.scroll_y;
+        scroll = scroll < 0 ? 0 : scroll;
+        if(list) {
+            widgets += list_ui(&ui, widget_count, values);
+        }
+        else {
+            widgets += grid_ui(&ui, widget_count, values, edits, scroll);
+        }
+        rf_ui_end(&ui);
+        rf_ui_build_vertices(&draw_list, 0, 0, glyph, NULL);
+
+        frame_ms[f] = (cpu_seconds() - start) * 1000.0;
+        total += frame_ms[f];
+        if(f) {
+            steady_allocs += alloc_count - allocs;
+        }
+    }
+
+    qsort(frame_ms, rec->frame_count, sizeof(double), compare_doubles);
+    result.mean_ms = total / rec->frame_count;
+    result.median_ms = frame_ms[rec->frame_count / 2];
+    result.p99_ms = frame_ms[(rec->frame_count * 99) / 100];
+    result.max_ms = frame_ms[rec->frame_count - 1];
+    result.allocs_per_frame = rec->frame_count > 1 ? (double)steady_allocs / (rec->frame_count - 1) : 0;
+    result.widgets_per_second = widgets / (total / 1000.0);
+
+    free(frame_ms);
+    free(edits);
+    free(values);
+    rf_ui_draw_list_clean_up(&draw_list);
+    rf_ui_clean_up(&ui);
+    return result;
+}
+
+int main(int argc, char **argv) {
+    const char *filename = argc > 1 ? argv[1] : "/tmp/rf_ui_bench.rfui";
+    uint32_t frames = argc > 2 ? (uint32_t)atoi(argv[2]) : 600;
+    if(!frames) {
+        frames = 600;
+    }
+
+    rf_UIRecording rec = rf_ui_recording_init();
+    if(load_session(filename, &rec)) {
+        printf("replaying %s (%u frames)\n", filename, rec.frame_count);
+    }
+    else {
+        generate_session(&rec, frames);
+        save_session(filename, &rec);
+        printf("generated %u frames, saved to %s\n", rec.frame_count, filename);
+    }
+    if(!rec.frame_count) {
+        fprintf(stderr, "%s: no frames to replay\n", filename);
+        return 1;
+    }
+
+    uint32_t widget_counts[] = { 1000, 10000, 100000 };
+
+    printf("%-4s %7s %9s %9s %9s %9s %12s %13s\n",
+           "ui", "widgets", "mean(ms)", "p50(ms)", "p99(ms)", "max(ms)", "allocs/frame", "widgets/s");
+
+    for(int list = 0; list < 2; list++) {
+        for(uint32_t w = 0; w < sizeof(widget_counts) / sizeof(widget_counts[0]); w++) {
+            BenchResult result = run(&rec, widget_counts[w], list);
+            printf("%-4s %7u %9.3f %9.3f %9.3f %9.3f %12.2f %13.0f\n",
+                   list ? "list" : "grid", widget_counts[w],
+                   result.mean_ms, result.median_ms, result.p99_ms, result.max_ms,
+                   result.allocs_per_frame, result.widgets_per_second);
+        }
+    }
+
+    rf_ui_recording_clean_up(&rec);
+    return 0;
+}
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+MIT License
+
+Copyright (c) 2017 Ryan Fleury
+
+Permission is hereby granted, free of charge, to any
+person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the
+Software without restriction, including without
+limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software
+is furnished to do so, subject to the following
+conditions: The above copyright notice and this permission
+notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF
+ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
@@ -0,0 +1,1144 @@
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+            SINGLE-HEADER C/++ FONT ATLAS/TEXT CACHE LIBRARY
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    DESCRIPTION
+
+        This is a single-header library that turns a TrueType
+        font (.ttf) into text you can measure and draw. It
+        parses the font in-process (no FreeType), rasterizes
+        glyphs on the CPU into an 8-bit coverage atlas as
+        they're first needed, and caches both glyphs and the
+        widths of whole strings, so laying out a label that
+        was already measured is a hash lookup instead of
+        per-glyph work.
+
+        It doesn't need a GPU or a window; uploading the atlas
+        to a texture is up to you (see THE ATLAS), so it works
+        just as well headless (for tests, or for measuring
+        text on a server).
+
+        It was written to be a front-end for rf_ui (its
+        callbacks plug straight into rf_UIState's
+        text_width_func and rf_ui_build_vertices), but it
+        doesn't depend on it.
+
+        It uses the CRT (realloc/free and math.h) by default,
+        but you can change the allocator (see CUSTOMIZATION).
+
+    USAGE
+
+        To use this library, you must #define
+        RF_FONT_IMPLEMENTATION in ONE .c or .cpp file before
+        #include'ing this file.
+
+        Load the .ttf file however you like, and keep it
+        around for as long as the font is used (rf_font reads
+        from it directly):
+
+            rf_Font font;
+            if(rf_font_init(&font, ttf_data, ttf_size, 512, 512) != RF_FONT_SUCCESS) {
+                // not a TrueType font, or one we can't use
+            }
+
+        The last two arguments are the size of the atlas.
+        Then, for each pixel size you want to use, make an
+        rf_FontFace:
+
+            rf_FontFace face = rf_font_face(&font, 16);
+
+            float width = rf_font_measure(&font, 16, "Hello", 5);
+            float line_h = rf_font_line_height(&font, 16);
+
+        Sizes are in pixels, from the top of the tallest
+        glyph (ascent) to the bottom of the lowest one
+        (descent); line heights add the font's line gap.
+
+        When you're done, call rf_font_clean_up:
+
+            rf_font_clean_up(&font);
+
+        Only simple and compound TrueType outlines ('glyf')
+        are supported, not CFF ('.otf' with PostScript
+        outlines). Kerning comes from the 'kern' table
+        (format 0), if the font has one.
+
+    WITH RF_UI
+
+        rf_font_text_width and rf_font_glyph have the shapes
+        of rf_UITextWidthFunc and rf_UIGlyphFunc; pass them
+        an rf_FontFace:
+
+            ui.text_width_func = rf_font_text_width;
+            ui.text_width_user = &face;
+            ui.line_height = rf_font_line_height(&font, 16);
+
+            // after rf_ui_end:
+
+            float white_u, white_v;
+            rf_font_white_uv(&font, &white_u, &white_v);
+            rf_ui_build_vertices(&draw_list, white_u, white_v,
+                                 rf_font_glyph, &face);
+
+        rf_font_glyph places glyphs so that the y passed to it
+        (the y of an rf_ui text command) is the top of the
+        line, and kerns a glyph against the one before it
+        when it's called right where the last one ended.
+
+        Nothing in rf_font locks: measuring fills the font's
+        glyph and width caches, so an rf_Font (and every face
+        made from it) must only be used by one thread at a
+        time. rf_ui calls text_width_func on whichever thread
+        builds a panel, so parallel panels each need a face
+        on a font of their own; fonts can share the same
+        .ttf data, since rf_font only reads it.
+
+    THE ATLAS
+
+        font.atlas is an atlas_w * atlas_h array of 8-bit
+        coverage values (0 = empty, 255 = fully covered), with
+        a small white square in the top left corner for
+        drawing untextured shapes (rf_font_white_uv gives
+        its UVs). Glyphs are packed into it in rows as they're
+        first drawn. After building a frame's vertices, check
+        whether any of it changed and upload that part:
+
+            int x, y, w, h;
+            if(rf_font_atlas_dirty(&font, &x, &y, &w, &h)) {
+                // upload rows y to y+h, columns x to x+w,
+                // of font.atlas (stride atlas_w)
+            }
+
+        If the atlas fills up, glyphs that don't fit aren't
+        drawn and font.atlas_full is set. Make the atlas
+        bigger, or call rf_font_reset_atlas between frames to
+        throw every glyph out and start over.
+
+    CACHING
+
+        Glyphs are cached by codepoint and size in an
+        open-addressed hash table, so each one is looked up
+        in the font's tables and rasterized once. Measuring
+        only needs a glyph's advance, so it never rasterizes.
+
+        rf_font_measure hashes the text and size and caches
+        the width in another hash table. Once the table holds
+        RF_FONT_MEASURE_CACHE_SIZE strings, it's emptied and
+        starts over, so it can't grow without bound when
+        labels change every frame.
+
+    CUSTOMIZATION
+
+        #define RF_FONT_REALLOC and RF_FONT_FREE to be the
+        identifiers of functions of your choosing to
+        stop rf_font from using the CRT's allocator. They
+        must have the forms:
+
+            void *realloc_func(void *data, size_t n)
+            void free_func(void *data)
+
+        #define RF_FONT_MEASURE_CACHE_SIZE to change how many
+        string widths are cached (4096 by default).
+
+    LICENSE INFORMATION IS AT THE END OF THE FILE
+*/
+
+#ifndef _RF_FONT_H
+#define _RF_FONT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef RF_FONT_REALLOC
+#include <stdlib.h>
+#define RF_FONT_REALLOC realloc
+#endif
+
+#ifndef RF_FONT_FREE
+#include <stdlib.h>
+#define RF_FONT_FREE free
+#endif
+
+#ifndef RF_FONT_MEASURE_CACHE_SIZE
+#define RF_FONT_MEASURE_CACHE_SIZE 4096
+#endif
+
+#define _RF_FONT_WHITE_SIZE 2
+#define _RF_FONT_TABLE_START_CAP 256
+
+enum {
+    RF_FONT_SUCCESS,
+    RF_FONT_ERROR_INVALID,
+    RF_FONT_ERROR_UNSUPPORTED,
+    RF_FONT_ERROR_MEMORY
+};
+
+typedef struct rf_FontGlyph {
+    uint32_t codepoint;
+    float size;
+    uint32_t glyph;
+    float advance;
+    int16_t x0, y0, x1, y1;
+    uint16_t atlas_x, atlas_y;
+    uint8_t used,
+            rasterized;
+} rf_FontGlyph;
+
+typedef struct rf_FontMeasure {
+    uint64_t hash;
+    float width;
+} rf_FontMeasure;
+
+typedef struct rf_Font {
+    const uint8_t *data;
+    size_t size;
+
+    uint32_t cmap, cmap_format,
+             loca, glyf, hmtx, kern;
+    uint32_t glyph_count,
+             hmetric_count,
+             kern_pairs;
+    int loca_long;
+    float units_per_em,
+          ascent, descent, line_gap;
+
+    uint8_t *atlas;
+    int atlas_w, atlas_h;
+    int shelf_x, shelf_y, shelf_h;
+    int dirty_x0, dirty_y0,
+        dirty_x1, dirty_y1;
+    int atlas_full;
+
+    rf_FontGlyph *glyphs;
+    uint32_t glyph_cache_count,
+             glyph_cache_cap;
+
+    rf_FontMeasure *measures;
+    uint32_t measure_count,
+             measure_cap;
+
+    float *raster;
+    uint32_t raster_cap;
+    float *points;
+    uint32_t point_cap;
+} rf_Font;
+
+typedef struct rf_FontFace {
+    rf_Font *font;
+    float size;
+    uint32_t last_glyph;
+    float pen_x, pen_y;
+} rf_FontFace;
+
+int rf_font_init(rf_Font *font, const void *data, size_t size, int atlas_w, int atlas_h);
+void rf_font_clean_up(rf_Font *font);
+rf_FontFace rf_font_face(rf_Font *font, float size);
+float rf_font_line_height(rf_Font *font, float size);
+float rf_font_ascent(rf_Font *font, float size);
+float rf_font_measure(rf_Font *font, float size, const char *text, uint32_t len);
+float rf_font_kern(rf_Font *font, float size, uint32_t left_glyph, uint32_t right_glyph);
+rf_FontGlyph *rf_font_get_glyph(rf_Font *font, uint32_t codepoint, float size, int rasterize);
+void rf_font_white_uv(rf_Font *font, float *u, float *v);
+int rf_font_atlas_dirty(rf_Font *font, int *x, int *y, int *w, int *h);
+void rf_font_reset_atlas(rf_Font *font);
+float rf_font_text_width(void *face, const char *text, uint32_t len);
+float rf_font_glyph(void *face, uint32_t codepoint, float x, float y, float *quad, float *uv);
+
+#ifdef RF_FONT_IMPLEMENTATION
+
+#include <math.h>
+
+// all reads are bounds-checked, so a broken font reads zeroes instead of crashing
+uint32_t _rf__font_u8(const rf_Font *font, uint32_t offset) {
+    return offset < font->size ? font->data[offset] : 0;
+}
+
+uint32_t _rf__font_u16(const rf_Font *font, uint32_t offset) {
+    return _rf__font_u8(font, offset) << 8 | _rf__font_u8(font, offset + 1);
+}
+
+int32_t _rf__font_i16(const rf_Font *font, uint32_t offset) {
+    return (int16_t)_rf__font_u16(font, offset);
+}
+
+uint32_t _rf__font_u32(const rf_Font *font, uint32_t offset) {
+    return _rf__font_u16(font, offset) << 16 | _rf__font_u16(font, offset + 2);
+}
+
+uint32_t _rf__font_find_table(const rf_Font *font, const char *tag) {
+    uint32_t table_count = _rf__font_u16(font, 4);
+    for(uint32_t i = 0; i < table_count; ++i) {
+        uint32_t record = 12 + 16 * i;
+        if(_rf__font_u8(font, record) == (uint8_t)tag[0] && _rf__font_u8(font, record + 1) == (uint8_t)tag[1] &&
+           _rf__font_u8(font, record + 2) == (uint8_t)tag[2] && _rf__font_u8(font, record + 3) == (uint8_t)tag[3]) {
+            return _rf__font_u32(font, record + 8);
+        }
+    }
+    return 0;
+}
+
+void *_rf__font_grow(void *data, uint32_t *cap, uint32_t element_size, uint32_t required) {
+    if(required > *cap) {
+        uint32_t new_cap = *cap ? *cap * 2 : _RF_FONT_TABLE_START_CAP;
+        while(new_cap < required) {
+            new_cap *= 2;
+        }
+        data = RF_FONT_REALLOC(data, (size_t)new_cap * element_size);
+        *cap = new_cap;
+    }
+    return data;
+}
+
+void rf_font_reset_atlas(rf_Font *font) {
+    for(int i = 0; i < font->atlas_w * font->atlas_h; ++i) {
+        font->atlas[i] = 0;
+    }
+    for(int y = 0; y < _RF_FONT_WHITE_SIZE; ++y) {
+        for(int x = 0; x < _RF_FONT_WHITE_SIZE; ++x) {
+            font->atlas[y * font->atlas_w + x] = 255;
+        }
+    }
+    font->shelf_x = _RF_FONT_WHITE_SIZE + 1;
+    font->shelf_y = 0;
+    font->shelf_h = _RF_FONT_WHITE_SIZE + 1;
+    font->dirty_x0 = font->dirty_y0 = 0;
+    font->dirty_x1 = font->atlas_w;
+    font->dirty_y1 = font->atlas_h;
+    font->atlas_full = 0;
+
+    for(uint32_t i = 0; i < font->glyph_cache_cap; ++i) {
+        font->glyphs[i].rasterized = 0;
+    }
+}
+
+int rf_font_init(rf_Font *font, const void *data, size_t size, int atlas_w, int atlas_h) {
+    font->data = (const uint8_t *)data;
+    font->size = size;
+    font->atlas = NULL;
+    font->glyphs = NULL;
+    font->glyph_cache_count = font->glyph_cache_cap = 0;
+    font->measures = NULL;
+    font->measure_count = font->measure_cap = 0;
+    font->raster = NULL;
+    font->raster_cap = 0;
+    font->points = NULL;
+    font->point_cap = 0;
+
+    uint32_t version = _rf__font_u32(font, 0);
+    if(version != 0x00010000 && version != 0x74727565) {
+        return version == 0x4f54544f ? RF_FONT_ERROR_UNSUPPORTED : RF_FONT_ERROR_INVALID;
+    }
+
+    uint32_t head = _rf__font_find_table(font, "head"),
+             hhea = _rf__font_find_table(font, "hhea"),
+             maxp = _rf__font_find_table(font, "maxp"),
+             cmap = _rf__font_find_table(font, "cmap");
+    font->loca = _rf__font_find_table(font, "loca");
+    font->glyf = _rf__font_find_table(font, "glyf");
+    font->hmtx = _rf__font_find_table(font, "hmtx");
+    font->kern = _rf__font_find_table(font, "kern");
+    if(!head || !hhea || !maxp || !cmap || !font->hmtx) {
+        return RF_FONT_ERROR_INVALID;
+    }
+    if(!font->loca || !font->glyf) {
+        return RF_FONT_ERROR_UNSUPPORTED;
+    }
+
+    font->units_per_em = (float)_rf__font_u16(font, head + 18);
+    font->loca_long = _rf__font_i16(font, head + 50) != 0;
+    font->ascent = (float)_rf__font_i16(font, hhea + 4);
+    font->descent = (float)_rf__font_i16(font, hhea + 6);
+    font->line_gap = (float)_rf__font_i16(font, hhea + 8);
+    font->hmetric_count = _rf__font_u16(font, hhea + 34);
+    font->glyph_count = _rf__font_u16(font, maxp + 4);
+    if(font->ascent <= font->descent || !font->hmetric_count) {
+        return RF_FONT_ERROR_INVALID;
+    }
+
+    // prefer a full unicode (format 12) subtable, then a BMP (format 4) one
+    font->cmap = 0;
+    font->cmap_format = 0;
+    uint32_t subtable_count = _rf__font_u16(font, cmap + 2);
+    for(uint32_t i = 0; i < subtable_count; ++i) {
+        uint32_t record = cmap + 4 + 8 * i,
+                 platform = _rf__font_u16(font, record),
+                 encoding = _rf__font_u16(font, record + 2),
+                 subtable = cmap + _rf__font_u32(font, record + 4),
+                 format = _rf__font_u16(font, subtable);
+        if((platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10))) &&
+           (format == 12 || (format == 4 && font->cmap_format != 12))) {
+            font->cmap = subtable;
+            font->cmap_format = format;
+        }
+    }
+    if(!font->cmap) {
+        return RF_FONT_ERROR_UNSUPPORTED;
+    }
+
+    // only a horizontal format 0 kern subtable is used
+    font->kern_pairs = 0;
+    if(font->kern && _rf__font_u16(font, font->kern) == 0 && _rf__font_u16(font, font->kern + 2) >= 1) {
+        uint32_t coverage = _rf__font_u16(font, font->kern + 8);
+        if((coverage & 0xff01) == 0x0001) {
+            font->kern_pairs = _rf__font_u16(font, font->kern + 10);
+        }
+    }
+
+    if(atlas_w < 16 || atlas_h < 16 || atlas_w > 65535 || atlas_h > 65535) {
+        return RF_FONT_ERROR_INVALID;
+    }
+    font->atlas_w = atlas_w;
+    font->atlas_h = atlas_h;
+    font->atlas = (uint8_t *)RF_FONT_REALLOC(NULL, (size_t)atlas_w * atlas_h);
+    if(!font->atlas) {
+        return RF_FONT_ERROR_MEMORY;
+    }
+    rf_font_reset_atlas(font);
+    return RF_FONT_SUCCESS;
+}
+
+void rf_font_clean_up(rf_Font *font) {
+    RF_FONT_FREE(font->atlas);
+    RF_FONT_FREE(font->glyphs);
+    RF_FONT_FREE(font->measures);
+    RF_FONT_FREE(font->raster);
+    RF_FONT_FREE(font->points);
+    font->atlas = NULL;
+    font->glyphs = NULL;
+    font->measures = NULL;
+    font->raster = NULL;
+    font->points = NULL;
+    font->glyph_cache_count = font->glyph_cache_cap = 0;
+    font->measure_count = font->measure_cap = 0;
+    font->raster_cap = 0;
+    font->point_cap = 0;
+}
+
+float _rf__font_scale(const rf_Font *font, float size) {
+    return size / (font->ascent - font->descent);
+}
+
+float rf_font_line_height(rf_Font *font, float size) {
+    return (font->ascent - font->descent + font->line_gap) * _rf__font_scale(font, size);
+}
+
+float rf_font_ascent(rf_Font *font, float size) {
+    return font->ascent * _rf__font_scale(font, size);
+}
+
+rf_FontFace rf_font_face(rf_Font *font, float size) {
+    rf_FontFace face;
+    face.font = font;
+    face.size = size;
+    face.last_glyph = 0;
+    face.pen_x = face.pen_y = -1e30f;
+    return face;
+}
+
+uint32_t _rf__font_glyph_index(const rf_Font *font, uint32_t codepoint) {
+    uint32_t cmap = font->cmap;
+    if(font->cmap_format == 12) {
+        uint32_t lo = 0, hi = _rf__font_u32(font, cmap + 12);
+        while(lo < hi) {
+            uint32_t mid = (lo + hi) / 2,
+                     group = cmap + 16 + 12 * mid,
+                     start = _rf__font_u32(font, group),
+                     end = _rf__font_u32(font, group + 4);
+            if(codepoint < start) {
+                hi = mid;
+            }
+            else if(codepoint > end) {
+                lo = mid + 1;
+            }
+            else {
+                return _rf__font_u32(font, group + 8) + codepoint - start;
+            }
+        }
+        return 0;
+    }
+
+    if(codepoint > 0xffff) {
+        return 0;
+    }
+    uint32_t seg_count = _rf__font_u16(font, cmap + 6) / 2,
+             end_codes = cmap + 14,
+             start_codes = end_codes + 2 * seg_count + 2,
+             deltas = start_codes + 2 * seg_count,
+             range_offsets = deltas + 2 * seg_count;
+    uint32_t lo = 0, hi = seg_count;
+    while(lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if(_rf__font_u16(font, end_codes + 2 * mid) < codepoint) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    if(lo >= seg_count) {
+        return 0;
+    }
+    uint32_t start = _rf__font_u16(font, start_codes + 2 * lo),
+             range_offset = _rf__font_u16(font, range_offsets + 2 * lo);
+    if(codepoint < start) {
+        return 0;
+    }
+    if(!range_offset) {
+        return (codepoint + _rf__font_u16(font, deltas + 2 * lo)) & 0xffff;
+    }
+    uint32_t glyph = _rf__font_u16(font, range_offsets + 2 * lo + range_offset + 2 * (codepoint - start));
+    return glyph ? (glyph + _rf__font_u16(font, deltas + 2 * lo)) & 0xffff : 0;
+}
+
+float _rf__font_advance(const rf_Font *font, uint32_t glyph) {
+    uint32_t metric = glyph < font->hmetric_count ? glyph : font->hmetric_count - 1;
+    return (float)_rf__font_u16(font, font->hmtx + 4 * metric);
+}
+
+float rf_font_kern(rf_Font *font, float size, uint32_t left_glyph, uint32_t right_glyph) {
+    uint32_t key = left_glyph << 16 | right_glyph,
+             pairs = font->kern + 18,
+             lo = 0, hi = font->kern_pairs;
+    while(lo < hi) {
+        uint32_t mid = (lo + hi) / 2,
+                 pair = _rf__font_u32(font, pairs + 6 * mid);
+        if(pair < key) {
+            lo = mid + 1;
+        }
+        else if(pair > key) {
+            hi = mid;
+        }
+        else {
+            return _rf__font_i16(font, pairs + 6 * mid + 4) * _rf__font_scale(font, size);
+        }
+    }
+    return 0;
+}
+
+uint32_t _rf__font_glyph_offset(const rf_Font *font, uint32_t glyph, uint32_t *length) {
+    uint32_t start, end;
+    if(glyph >= font->glyph_count) {
+        *length = 0;
+        return 0;
+    }
+    if(font->loca_long) {
+        start = _rf__font_u32(font, font->loca + 4 * glyph);
+        end = _rf__font_u32(font, font->loca + 4 * glyph + 4);
+    }
+    else {
+        start = _rf__font_u16(font, font->loca + 2 * glyph) * 2;
+        end = _rf__font_u16(font, font->loca + 2 * glyph + 2) * 2;
+    }
+    *length = end > start ? end - start : 0;
+    return font->glyf + start;
+}
+
+typedef struct _rf__FontRaster {
+    float *cells;
+    int w, h;
+    float transform[6];
+} _rf__FontRaster;
+
+// accumulates the signed area a line covers in each cell; a running sum over
+// the cells afterwards gives the coverage of every pixel
+void _rf__font_raster_line(_rf__FontRaster *r, float x0, float y0, float x1, float y1) {
+    if(fabsf(y0 - y1) <= 1e-6f) {
+        return;
+    }
+    float dir = 1;
+    if(y0 > y1) {
+        float t;
+        t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+        dir = -1;
+    }
+    float dxdy = (x1 - x0) / (y1 - y0),
+          x = x0;
+    if(y0 < 0) {
+        x -= y0 * dxdy;
+    }
+    int y_end = (int)ceilf(y1) < r->h ? (int)ceilf(y1) : r->h;
+    for(int y = y0 > 0 ? (int)y0 : 0; y < y_end; ++y) {
+        float *line = r->cells + y * r->w;
+        float dy = ((float)(y + 1) < y1 ? (float)(y + 1) : y1) - ((float)y > y0 ? (float)y : y0),
+              x_next = x + dxdy * dy,
+              d = dy * dir,
+              max_x = (float)(r->w - 2),
+              cx0 = x < 0 ? 0 : (x > max_x ? max_x : x),
+              cx1 = x_next < 0 ? 0 : (x_next > max_x ? max_x : x_next),
+              left = cx0 < cx1 ? cx0 : cx1,
+              right = cx0 < cx1 ? cx1 : cx0,
+              left_floor = floorf(left);
+        int left_i = (int)left_floor,
+            right_i = (int)ceilf(right);
+        if(right_i <= left_i + 1) {
+            float mid = 0.5f * (cx0 + cx1) - left_floor;
+            line[left_i] += d - d * mid;
+            line[left_i + 1] += d * mid;
+        }
+        else {
+            float s = 1.0f / (right - left),
+                  left_f = left - left_floor,
+                  a0 = 0.5f * s * (1 - left_f) * (1 - left_f),
+                  right_f = right - (float)right_i + 1,
+                  am = 0.5f * s * right_f * right_f;
+            line[left_i] += d * a0;
+            if(right_i == left_i + 2) {
+                line[left_i + 1] += d * (1 - a0 - am);
+            }
+            else {
+                float a1 = s * (1.5f - left_f);
+                line[left_i + 1] += d * (a1 - a0);
+                for(int xi = left_i + 2; xi < right_i - 1; ++xi) {
+                    line[xi] += d * s;
+                }
+                float a2 = a1 + (float)(right_i - left_i - 3) * s;
+                line[right_i - 1] += d * (1 - a2 - am);
+            }
+            line[right_i] += d * am;
+        }
+        x = x_next;
+    }
+}
+
+void _rf__font_raster_point(_rf__FontRaster *r, float fx, float fy, float *x, float *y) {
+    *x = r->transform[0] * fx + r->transform[2] * fy + r->transform[4];
+    *y = r->transform[1] * fx + r->transform[3] * fy + r->transform[5];
+}
+
+void _rf__font_raster_quad(_rf__FontRaster *r, float x0, float y0, float cx, float cy, float x1, float y1) {
+    float dx = x0 - 2 * cx + x1,
+          dy = y0 - 2 * cy + y1,
+          dd = dx * dx + dy * dy;
+    if(dd < 0.333f) {
+        _rf__font_raster_line(r, x0, y0, x1, y1);
+        return;
+    }
+    int steps = 1 + (int)floorf(sqrtf(sqrtf(3 * dd)));
+    float px = x0, py = y0;
+    for(int i = 1; i <= steps; ++i) {
+        float t = (float)i / steps,
+              mt = 1 - t,
+              nx = mt * mt * x0 + 2 * mt * t * cx + t * t * x1,
+              ny = mt * mt * y0 + 2 * mt * t * cy + t * t * y1;
+        _rf__font_raster_line(r, px, py, nx, ny);
+        px = nx;
+        py = ny;
+    }
+}
+
+
+void _rf__font_raster_contours(rf_Font *font, _rf__FontRaster *r, uint32_t offset, int32_t contour_count) {
+    uint32_t ends = offset + 10,
+             point_count = _rf__font_u16(font, ends + 2 * (contour_count - 1)) + 1,
+             p = ends + 2 * contour_count;
+    p += 2 + _rf__font_u16(font, p);
+
+    // decode the points (x, y, on curve) first, then walk the contours over them
+    font->points = (float *)_rf__font_grow(font->points, &font->point_cap, 3 * sizeof(float), point_count);
+    float *points = font->points;
+
+    uint32_t flags = p,
+             repeat = 0,
+             flag = 0;
+    for(uint32_t i = 0; i < point_count; ++i) {
+        if(!repeat) {
+            flag = _rf__font_u8(font, p++);
+            repeat = flag & 0x08 ? _rf__font_u8(font, p++) + 1 : 1;
+        }
+        --repeat;
+        points[3 * i + 2] = (float)(flag & 0x01);
+    }
+
+    // the x coordinates follow the flags, and the y coordinates follow those
+    uint32_t coordinates = p;
+    for(int axis = 0; axis < 2; ++axis) {
+        uint32_t short_flag = axis ? 0x04 : 0x02,
+                 same_flag = axis ? 0x20 : 0x10;
+        int32_t value = 0;
+        p = flags;
+        repeat = 0;
+        for(uint32_t i = 0; i < point_count; ++i) {
+            if(!repeat) {
+                flag = _rf__font_u8(font, p++);
+                repeat = flag & 0x08 ? _rf__font_u8(font, p++) + 1 : 1;
+            }
+            --repeat;
+            if(flag & short_flag) {
+                int32_t delta = (int32_t)_rf__font_u8(font, coordinates++);
+                value += flag & same_flag ? delta : -delta;
+            }
+            else if(!(flag & same_flag)) {
+                value += _rf__font_i16(font, coordinates);
+                coordinates += 2;
+            }
+            points[3 * i + axis] = (float)value;
+        }
+    }
+    for(uint32_t i = 0; i < point_count; ++i) {
+        float x = points[3 * i],
+              y = points[3 * i + 1];
+        _rf__font_raster_point(r, x, y, points + 3 * i, points + 3 * i + 1);
+    }
+
+    uint32_t start = 0;
+    for(int32_t contour = 0; contour < contour_count; ++contour) {
+        uint32_t end = _rf__font_u16(font, ends + 2 * contour);
+        if(end >= point_count || end < start) {
+            break;
+        }
+
+        // a contour can begin on an off-curve point; then it really begins at
+        // the last point, or between the first and last ones if both are off
+        float *first = points + 3 * start,
+              *last = points + 3 * end;
+        float start_x, start_y;
+        uint32_t from = start,
+                 to = end;
+        if(first[2]) {
+            start_x = first[0];
+            start_y = first[1];
+            from = start + 1;
+        }
+        else if(last[2]) {
+            start_x = last[0];
+            start_y = last[1];
+            to = end - 1;
+        }
+        else {
+            start_x = (first[0] + last[0]) / 2;
+            start_y = (first[1] + last[1]) / 2;
+        }
+
+        float x = start_x,
+              y = start_y,
+              control_x = 0,
+              control_y = 0;
+        int has_control = 0;
+        for(uint32_t i = from; i <= to && i <= end; ++i) {
+            float *point = points + 3 * i;
+            if(point[2]) {
+                if(has_control) {
+                    _rf__font_raster_quad(r, x, y, control_x, control_y, point[0], point[1]);
+                }
+                else {
+                    _rf__font_raster_line(r, x, y, point[0], point[1]);
+                }
+                x = point[0];
+                y = point[1];
+                has_control = 0;
+            }
+            else {
+                if(has_control) {
+                    float mid_x = (control_x + point[0]) / 2,
+                          mid_y = (control_y + point[1]) / 2;
+                    _rf__font_raster_quad(r, x, y, control_x, control_y, mid_x, mid_y);
+                    x = mid_x;
+                    y = mid_y;
+                }
+                control_x = point[0];
+                control_y = point[1];
+                has_control = 1;
+            }
+        }
+        if(has_control) {
+            _rf__font_raster_quad(r, x, y, control_x, control_y, start_x, start_y);
+        }
+        else {
+            _rf__font_raster_line(r, x, y, start_x, start_y);
+        }
+
+        start = end + 1;
+    }
+}
+
+void _rf__font_raster_glyph(rf_Font *font, _rf__FontRaster *r, uint32_t glyph, int depth) {
+    uint32_t length,
+             offset = _rf__font_glyph_offset(font, glyph, &length);
+    if(!length || depth > 8) {
+        return;
+    }
+
+    int32_t contour_count = _rf__font_i16(font, offset);
+    if(contour_count > 0) {
+        _rf__font_raster_contours(font, r, offset, contour_count);
+        return;
+    }
+
+    // a compound glyph draws other glyphs, each with its own transform
+    uint32_t p = offset + 10,
+             flags;
+    float parent[6];
+    for(int i = 0; i < 6; ++i) {
+        parent[i] = r->transform[i];
+    }
+    do {
+        flags = _rf__font_u16(font, p);
+        uint32_t component = _rf__font_u16(font, p + 2);
+        float dx, dy,
+              a = 1, b = 0, c = 0, d = 1;
+        p += 4;
+        if(flags & 0x0001) {
+            dx = (float)_rf__font_i16(font, p);
+            dy = (float)_rf__font_i16(font, p + 2);
+            p += 4;
+        }
+        else {
+            dx = (float)(int8_t)_rf__font_u8(font, p);
+            dy = (float)(int8_t)_rf__font_u8(font, p + 1);
+            p += 2;
+        }
+        if(!(flags & 0x0002)) {
+            // components positioned by matching points aren't supported
+            dx = dy = 0;
+        }
+        if(flags & 0x0008) {
+            a = d = _rf__font_i16(font, p) / 16384.0f;
+            p += 2;
+        }
+        else if(flags & 0x0040) {
+            a = _rf__font_i16(font, p) / 16384.0f;
+            d = _rf__font_i16(font, p + 2) / 16384.0f;
+            p += 4;
+        }
+        else if(flags & 0x0080) {
+            a = _rf__font_i16(font, p) / 16384.0f;
+            b = _rf__font_i16(font, p + 2) / 16384.0f;
+            c = _rf__font_i16(font, p + 4) / 16384.0f;
+            d = _rf__font_i16(font, p + 6) / 16384.0f;
+            p += 8;
+        }
+        r->transform[0] = parent[0] * a + parent[2] * b;
+        r->transform[1] = parent[1] * a + parent[3] * b;
+        r->transform[2] = parent[0] * c + parent[2] * d;
+        r->transform[3] = parent[1] * c + parent[3] * d;
+        r->transform[4] = parent[0] * dx + parent[2] * dy + parent[4];
+        r->transform[5] = parent[1] * dx + parent[3] * dy + parent[5];
+        _rf__font_raster_glyph(font, r, component, depth + 1);
+    } while(flags & 0x0020);
+    for(int i = 0; i < 6; ++i) {
+        r->transform[i] = parent[i];
+    }
+}
+
+void _rf__font_touch_atlas(rf_Font *font, int x0, int y0, int x1, int y1) {
+    if(font->dirty_x1 <= font->dirty_x0 || font->dirty_y1 <= font->dirty_y0) {
+        font->dirty_x0 = x0;
+        font->dirty_y0 = y0;
+        font->dirty_x1 = x1;
+        font->dirty_y1 = y1;
+        return;
+    }
+    font->dirty_x0 = x0 < font->dirty_x0 ? x0 : font->dirty_x0;
+    font->dirty_y0 = y0 < font->dirty_y0 ? y0 : font->dirty_y0;
+    font->dirty_x1 = x1 > font->dirty_x1 ? x1 : font->dirty_x1;
+    font->dirty_y1 = y1 > font->dirty_y1 ? y1 : font->dirty_y1;
+}
+
+// rasterizes a glyph and packs it into the atlas in rows ("shelves")
+void _rf__font_rasterize(rf_Font *font, rf_FontGlyph *glyph) {
+    uint32_t length,
+             offset = _rf__font_glyph_offset(font, glyph->glyph, &length);
+    float scale = _rf__font_scale(font, glyph->size);
+
+    glyph->x0 = glyph->y0 = glyph->x1 = glyph->y1 = 0;
+    glyph->rasterized = 1;
+    if(!length) {
+        return;
+    }
+
+    int pad = 1,
+        x0 = (int)floorf(_rf__font_i16(font, offset + 2) * scale) - pad,
+        y0 = (int)floorf(-_rf__font_i16(font, offset + 8) * scale) - pad,
+        x1 = (int)ceilf(_rf__font_i16(font, offset + 6) * scale) + pad,
+        y1 = (int)ceilf(-_rf__font_i16(font, offset + 4) * scale) + pad,
+        w = x1 - x0,
+        h = y1 - y0;
+    if(w <= 2 * pad || h <= 2 * pad) {
+        return;
+    }
+    if(w + 1 > font->atlas_w || h + 1 > font->atlas_h) {
+        glyph->rasterized = 2;
+        font->atlas_full = 1;
+        return;
+    }
+
+    if(font->shelf_x + w > font->atlas_w) {
+        font->shelf_x = 0;
+        font->shelf_y += font->shelf_h;
+        font->shelf_h = 0;
+    }
+    if(font->shelf_y + h > font->atlas_h) {
+        glyph->rasterized = 2;
+        font->atlas_full = 1;
+        return;
+    }
+    int atlas_x = font->shelf_x,
+        atlas_y = font->shelf_y;
+    font->shelf_x += w + 1;
+    font->shelf_h = h + 1 > font->shelf_h ? h + 1 : font->shelf_h;
+
+    _rf__FontRaster r;
+    r.w = w + 2;
+    r.h = h;
+    font->raster = (float *)_rf__font_grow(font->raster, &font->raster_cap, sizeof(float), (uint32_t)(r.w * r.h));
+    r.cells = font->raster;
+    for(int i = 0; i < r.w * r.h; ++i) {
+        r.cells[i] = 0;
+    }
+    r.transform[0] = scale;
+    r.transform[1] = 0;
+    r.transform[2] = 0;
+    r.transform[3] = -scale;
+    r.transform[4] = (float)-x0;
+    r.transform[5] = (float)-y0;
+    _rf__font_raster_glyph(font, &r, glyph->glyph, 0);
+
+    for(int y = 0; y < h; ++y) {
+        float *cells = r.cells + y * r.w,
+              coverage = 0;
+        uint8_t *out = font->atlas + (atlas_y + y) * font->atlas_w + atlas_x;
+        for(int x = 0; x < w; ++x) {
+            coverage += cells[x];
+            float a = fabsf(coverage);
+            out[x] = (uint8_t)(a >= 1 ? 255 : a * 255 + 0.5f);
+        }
+    }
+    _rf__font_touch_atlas(font, atlas_x, atlas_y, atlas_x + w, atlas_y + h);
+
+    glyph->x0 = (int16_t)x0;
+    glyph->y0 = (int16_t)y0;
+    glyph->x1 = (int16_t)x1;
+    glyph->y1 = (int16_t)y1;
+    glyph->atlas_x = (uint16_t)atlas_x;
+    glyph->atlas_y = (uint16_t)atlas_y;
+}
+
+uint32_t _rf__font_glyph_slot(uint32_t codepoint, float size, uint32_t mask) {
+    uint32_t size_bits = (uint32_t)(size * 64);
+    return ((codepoint * 2654435761u) ^ (size_bits * 40503u)) & mask;
+}
+
+// the pointer is valid until the next call that adds a glyph
+rf_FontGlyph *rf_font_get_glyph(rf_Font *font, uint32_t codepoint, float size, int rasterize) {
+    if(font->glyph_cache_count * 2 >= font->glyph_cache_cap) {
+        rf_FontGlyph *old = font->glyphs;
+        uint32_t old_cap = font->glyph_cache_cap,
+                 cap = old_cap ? old_cap * 2 : _RF_FONT_TABLE_START_CAP;
+        font->glyphs = (rf_FontGlyph *)RF_FONT_REALLOC(NULL, cap * sizeof(rf_FontGlyph));
+        font->glyph_cache_cap = cap;
+        for(uint32_t i = 0; i < cap; ++i) {
+            font->glyphs[i].used = 0;
+        }
+        for(uint32_t i = 0; i < old_cap; ++i) {
+            if(old[i].used) {
+                uint32_t slot = _rf__font_glyph_slot(old[i].codepoint, old[i].size, cap - 1);
+                while(font->glyphs[slot].used) {
+                    slot = (slot + 1) & (cap - 1);
+                }
+                font->glyphs[slot] = old[i];
+            }
+        }
+        RF_FONT_FREE(old);
+    }
+
+    uint32_t mask = font->glyph_cache_cap - 1,
+             slot = _rf__font_glyph_slot(codepoint, size, mask);
+    rf_FontGlyph *glyph = font->glyphs + slot;
+    while(glyph->used && (glyph->codepoint != codepoint || glyph->size != size)) {
+        slot = (slot + 1) & mask;
+        glyph = font->glyphs + slot;
+    }
+
+    if(!glyph->used) {
+        glyph->used = 1;
+        glyph->rasterized = 0;
+        glyph->codepoint = codepoint;
+        glyph->size = size;
+        glyph->glyph = _rf__font_glyph_index(font, codepoint);
+        glyph->advance = _rf__font_advance(font, glyph->glyph) * _rf__font_scale(font, size);
+        glyph->x0 = glyph->y0 = glyph->x1 = glyph->y1 = 0;
+        glyph->atlas_x = glyph->atlas_y = 0;
+        ++font->glyph_cache_count;
+    }
+    if(rasterize && !glyph->rasterized) {
+        _rf__font_rasterize(font, glyph);
+    }
+    return glyph;
+}
+
+uint32_t _rf__font_utf8_decode(const char *text, uint32_t len, uint32_t *codepoint) {
+    const uint8_t *s = (const uint8_t *)text;
+    uint32_t size = s[0] < 0x80 ? 1 : s[0] < 0xe0 ? 2 : s[0] < 0xf0 ? 3 : 4;
+    if(size > len || (s[0] >= 0x80 && s[0] < 0xc0)) {
+        *codepoint = 0xfffd;
+        return 1;
+    }
+    switch(size) {
+        case 1: *codepoint = s[0]; break;
+        case 2: *codepoint = (s[0] & 0x1f) << 6 | (s[1] & 0x3f); break;
+        case 3: *codepoint = (s[0] & 0x0f) << 12 | (s[1] & 0x3f) << 6 | (s[2] & 0x3f); break;
+        default: *codepoint = (s[0] & 0x07) << 18 | (s[1] & 0x3f) << 12 | (s[2] & 0x3f) << 6 | (s[3] & 0x3f); break;
+    }
+    return size;
+}
+
+uint64_t _rf__font_hash(const char *text, uint32_t len, float size) {
+    uint64_t hash = 14695981039346656037ull;
+    for(uint32_t i = 0; i < len; ++i) {
+        hash = (hash ^ (uint8_t)text[i]) * 1099511628211ull;
+    }
+    hash = (hash ^ (uint64_t)(uint32_t)(size * 64)) * 1099511628211ull;
+    return hash | 1;
+}
+
+float rf_font_measure(rf_Font *font, float size, const char *text, uint32_t len) {
+    if(!len) {
+        return 0;
+    }
+
+    if(font->measure_count >= RF_FONT_MEASURE_CACHE_SIZE) {
+        for(uint32_t i = 0; i < font->measure_cap; ++i) {
+            font->measures[i].hash = 0;
+        }
+        font->measure_count = 0;
+    }
+    if(font->measure_count * 2 >= font->measure_cap) {
+        rf_FontMeasure *old = font->measures;
+        uint32_t old_cap = font->measure_cap,
+                 cap = old_cap ? old_cap * 2 : _RF_FONT_TABLE_START_CAP;
+        font->measures = (rf_FontMeasure *)RF_FONT_REALLOC(NULL, cap * sizeof(rf_FontMeasure));
+        font->measure_cap = cap;
+        for(uint32_t i = 0; i < cap; ++i) {
+            font->measures[i].hash = 0;
+        }
+        for(uint32_t i = 0; i < old_cap; ++i) {
+            if(old[i].hash) {
+                uint32_t slot = (uint32_t)(old[i].hash >> 32) & (cap - 1);
+                while(font->measures[slot].hash) {
+                    slot = (slot + 1) & (cap - 1);
+                }
+                font->measures[slot] = old[i];
+            }
+        }
+        RF_FONT_FREE(old);
+    }
+
+    uint64_t hash = _rf__font_hash(text, len, size);
+    uint32_t mask = font->measure_cap - 1,
+             slot = (uint32_t)(hash >> 32) & mask;
+    while(font->measures[slot].hash) {
+        if(font->measures[slot].hash == hash) {
+            return font->measures[slot].width;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    float width = 0;
+    uint32_t last_glyph = 0;
+    for(uint32_t i = 0; i < len;) {
+        uint32_t codepoint;
+        i += _rf__font_utf8_decode(text + i, len - i, &codepoint);
+        rf_FontGlyph *glyph = rf_font_get_glyph(font, codepoint, size, 0);
+        if(last_glyph) {
+            width += rf_font_kern(font, size, last_glyph, glyph->glyph);
+        }
+        width += glyph->advance;
+        last_glyph = glyph->glyph;
+    }
+
+    font->measures[slot].hash = hash;
+    font->measures[slot].width = width;
+    ++font->measure_count;
+    return width;
+}
+
+void rf_font_white_uv(rf_Font *font, float *u, float *v) {
+    *u = (_RF_FONT_WHITE_SIZE / 2.0f) / font->atlas_w;
+    *v = (_RF_FONT_WHITE_SIZE / 2.0f) / font->atlas_h;
+}
+
+int rf_font_atlas_dirty(rf_Font *font, int *x, int *y, int *w, int *h) {
+    if(font->dirty_x1 <= font->dirty_x0 || font->dirty_y1 <= font->dirty_y0) {
+        return 0;
+    }
+    *x = font->dirty_x0;
+    *y = font->dirty_y0;
+    *w = font->dirty_x1 - font->dirty_x0;
+    *h = font->dirty_y1 - font->dirty_y0;
+    font->dirty_x0 = font->dirty_y0 = font->dirty_x1 = font->dirty_y1 = 0;
+    return 1;
+}
+
+float rf_font_text_width(void *face, const char *text, uint32_t len) {
+    rf_FontFace *f = (rf_FontFace *)face;
+    return rf_font_measure(f->font, f->size, text, len);
+}
+
+float rf_font_glyph(void *face, uint32_t codepoint, float x, float y, float *quad, float *uv) {
+    rf_FontFace *f = (rf_FontFace *)face;
+    rf_Font *font = f->font;
+    rf_FontGlyph *glyph = rf_font_get_glyph(font, codepoint, f->size, 1);
+
+    // kern against the previous glyph if this one continues the same run;
+    // the caller sums our return values itself, so allow for rounding
+    float kern = 0;
+    if(f->last_glyph && y == f->pen_y && fabsf(x - f->pen_x) < 0.01f) {
+        kern = rf_font_kern(font, f->size, f->last_glyph, glyph->glyph);
+    }
+    float step = kern + glyph->advance;
+    f->last_glyph = glyph->glyph;
+    f->pen_x = x + step;
+    f->pen_y = y;
+
+    if(glyph->rasterized == 1 && glyph->x1 > glyph->x0) {
+        float left = floorf(x + kern + 0.5f),
+              baseline = floorf(y + rf_font_ascent(font, f->size) + 0.5f);
+        quad[0] = left + glyph->x0;
+        quad[1] = baseline + glyph->y0;
+        quad[2] = left + glyph->x1;
+        quad[3] = baseline + glyph->y1;
+        uv[0] = (float)glyph->atlas_x / font->atlas_w;
+        uv[1] = (float)glyph->atlas_y / font->atlas_h;
+        uv[2] = (float)(glyph->atlas_x + glyph->x1 - glyph->x0) / font->atlas_w;
+        uv[3] = (float)(glyph->atlas_y + glyph->y1 - glyph->y0) / font->atlas_h;
+    }
+    return step;
+}
+
+#endif /* RF_FONT_IMPLEMENTATION */
+
+#endif
+
+/*
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+MIT License
+
+Copyright (c) 2017 Ryan Fleury
+
+Permission is hereby granted, free of charge, to any
+person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the
+Software without restriction, including without
+limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software
+is furnished to do so, subject to the following
+conditions: The above copyright notice and this permission
+notice shall be included in all copies or substantial
+portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF
+ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+*/
@@ -11,10 +11,16 @@
         indices, the functions in this file will
         launch threads as necessary in order to load
         raw data, if found, at said filenames.
+        Resources can depend on other resources,
+        in which case the whole dependency graph
+        is loaded in parallel.
         This raw data can then be retrieved and used
         however you want.
         
         Its only dependencies are the CRT/pthread.
+        CPU pinning and NUMA placement use raw Linux
+        syscalls (no libnuma) and do nothing on other
+        platforms.
 
     USAGE
 	
@@ -52,6 +58,92 @@
               pointers). Returns 1 if successful,
               0 otherwise.
 
+        * rf_mtr_add_dependency
+              declares that one resource depends on
+              another. Requesting a resource requests
+              everything it (transitively) depends
+              on, so the whole graph is loaded in one
+              go. Can be called from a parse callback
+              to add dependencies discovered while
+              loading.
+
+        * rf_mtr_set_parse_func
+              sets a callback that is called on a
+              loader thread right after a resource's
+              data has been read (before it becomes
+              grabbable). Use it to find references
+              to other resources and declare them
+              with rf_mtr_add_dependency; they will
+              be loaded by the same loader threads
+              without waiting for another
+              rf_mtr_update (loaders with nothing to
+              do wait while any load is still in
+              progress, since it may add more).
+
+        * rf_mtr_dependencies_ready
+              returns 1 when a resource and all of
+              the resources it (transitively) depends
+              on have finished loading, -1 if any of
+              them failed or timed out, 0 otherwise.
+
+        * rf_mtr_resource_status
+              returns the RF_MTR_STATUS_ of a
+              resource (QUEUED, LOADING, READY,
+              FAILED, TIMED_OUT...) and, if the
+              passed pointer isn't NULL, the errno
+              value of its last failure.
+
+        * rf_mtr_set_retry_policy
+              sets how many times a load is retried
+              after a transient failure (EINTR,
+              EAGAIN, EBUSY, EMFILE, ENFILE, EIO),
+              the backoff before the first retry (in
+              milliseconds, doubled for every retry
+              after that, up to an hour), and how
+              long a request may take before it
+              times out (0 for no timeout). No
+              retries and no timeout by default.
+
+        * rf_mtr_set_thread_count
+              sets how many loader threads are
+              launched per load (1 by default, at
+              most RF_MTR_MAX_THREADS). Takes effect
+              the next time loading starts.
+
+        * rf_mtr_set_loader_cpus
+              pins loader threads to CPUs. Loader
+              thread i is pinned to cpus[i % count].
+              Pass a count of 0 to stop pinning.
+
+        * rf_mtr_set_numa_node
+              sets the NUMA node that loader threads
+              prefer to allocate load buffers on
+              (-1, the default, leaves the memory
+              policy alone). Use the node of the
+              threads that consume the data, e.g.
+              rf_mtr_current_numa_node called from
+              one of them.
+
+        * rf_mtr_set_resource_numa_node
+              overrides the NUMA node for a single
+              resource's buffer, for when different
+              resources are consumed on different
+              nodes.
+
+        * rf_mtr_wait
+              registers an rf_MTRWaiter whose
+              callback is called once a resource is
+              READY, FAILED or TIMED_OUT. The waiter
+              is stored intrusively, so it must stay
+              alive until it is called. Returns 0
+              (and doesn't register anything) if the
+              resource has already finished.
+              Callbacks are only ever called on a
+              loader thread or from rf_mtr_update
+              (which is where timeouts are noticed
+              when a read hangs), never from the
+              status queries.
+
         --------------------------------------------
 
         In order to start using this, you should
@@ -104,6 +196,96 @@
         }
         rf_mtr_clean_up(&rs_master);
 
+    DEPENDENCY EXAMPLE
+
+        // file1.txt holds a list of other resource
+        // indices that it needs
+        void parse(rf_ResourceMaster *r, uint16_t index,
+                   void *data, int64_t data_len,
+                   void *user_data) {
+            if(index == RS_FILE_1) {
+                for(int64_t i = 0; i < data_len; i++) {
+                    char c = ((char *)data)[i];
+                    if(c >= '0' && c < '0' + MAX_RS) {
+                        rf_mtr_add_dependency(r, index, c - '0');
+                    }
+                }
+            }
+        }
+
+        rf_mtr_add_dependency(&rs_master, RS_FILE_2, RS_FILE_3);
+        rf_mtr_set_parse_func(&rs_master, parse, NULL);
+        rf_mtr_set_thread_count(&rs_master, 4);
+
+        rf_mtr_request(&rs_master, RS_FILE_1);
+        while(!rf_mtr_dependencies_ready(&rs_master, RS_FILE_1)) {
+            rf_mtr_update(&rs_master);
+        }
+
+    C++20 COROUTINES
+
+        When compiled as C++20, rf_mtr_async returns
+        an awaitable that requests a resource and
+        suspends the coroutine until it has finished
+        loading. co_await gives back an rf_MTRResult
+        with the status, the errno value, and the
+        grabbed data (which is yours to free).
+        Data can only be grabbed once: if it was
+        already taken (by rf_mtr_grab_resource_data
+        or another coroutine awaiting the same
+        resource), the status is still
+        RF_MTR_STATUS_READY but data is NULL, so
+        have one owner await each resource.
+
+        By default, the coroutine is resumed on the
+        loader thread that finished the resource (or
+        in rf_mtr_update, if it timed out there).
+        Pass an rf_MTRExecutor to choose where it
+        resumes instead. rf_MTRQueueExecutor queues
+        coroutines until its run() is called, so
+        calling it from your main loop resumes them
+        on the main thread:
+
+            rf_MTRQueueExecutor main_thread;
+
+            Task load_level(rf_ResourceMaster *r) {
+                rf_MTRResult level = co_await rf_mtr_async(r, RS_FILE_1, &main_thread);
+                if(level.status == RF_MTR_STATUS_READY) {
+                    // ...
+                    free(level.data);
+                }
+            }
+
+            while(1) {
+                rf_mtr_update(&rs_master);
+                main_thread.run();
+            }
+
+        Loading still only starts from rf_mtr_update,
+        so keep calling it. Coroutines still waiting
+        when rf_mtr_clean_up is called are never
+        resumed.
+
+    ERRORS
+
+        A resource that couldn't be loaded never
+        becomes ready, so don't just poll
+        rf_mtr_grab_resource_data forever. Check
+        rf_mtr_resource_status instead:
+
+            int error = 0;
+            switch(rf_mtr_resource_status(&rs_master, RS_FILE_1, &error)) {
+                case RF_MTR_STATUS_FAILED:
+                case RF_MTR_STATUS_TIMED_OUT: {
+                    printf("Couldn't load: %s\n", strerror(error));
+                    break;
+                }
+                default: break;
+            }
+
+        A failed or timed-out resource can be
+        requested again with rf_mtr_request.
+
     WARNING
 	
         You're in charge of how the data loaded
@@ -128,13 +310,80 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <errno.h>
+#include <time.h>
 #include <pthread.h>
 
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#ifndef RF_MTR_MAX_THREADS
+#define RF_MTR_MAX_THREADS 4
+#endif
+
+#define _RF_MTR_NO_RESOURCE         0xffff
+#define _RF_MTR_MAX_RETRY_BACKOFF   (60 * 60 * 1000)
+#define _RF_MTR_MAX_CPUS            1024
+#define _RF_MTR_MAX_NUMA_NODES      256
+#define _RF_MTR_MPOL_PREFERRED      1
+#define _RF_MTR_MPOL_MF_MOVE        (1 << 1)
+
+enum {
+    _RF_MTR_LIST_NONE,
+    _RF_MTR_LIST_READY,
+    _RF_MTR_LIST_RETRY
+};
+
+enum {
+    RF_MTR_STATUS_NONE,
+    RF_MTR_STATUS_QUEUED,
+    RF_MTR_STATUS_LOADING,
+    RF_MTR_STATUS_READY,
+    RF_MTR_STATUS_FAILED,
+    RF_MTR_STATUS_TIMED_OUT,
+    RF_MTR_MAX_STATUS
+};
+
+typedef struct rf_ResourceMaster rf_ResourceMaster;
+
+typedef void (* rf_MTRParseFunc)(rf_ResourceMaster *r, uint16_t index, void *data, int64_t data_len, void *user_data);
+typedef void (* rf_MTRWaitFunc)(rf_ResourceMaster *r, uint16_t index, int8_t status, void *user_data);
+
+typedef struct rf_MTRWaiter rf_MTRWaiter;
+
+typedef struct rf_MTRWaiter {
+    rf_MTRWaitFunc func;
+    void *user_data;
+    uint16_t index;
+    int8_t status;
+    rf_MTRWaiter *next;
+} rf_MTRWaiter;
+
 typedef struct rf_Resource {
-    int8_t need_load;
+    int8_t status,
+           requested;
     const char *filename;
     int64_t data_len;
     void *data;
+
+    int error;
+    int16_t numa_node;
+    uint8_t attempts;
+    uint32_t generation;
+    int64_t retry_time,
+            deadline;
+
+    rf_MTRWaiter *waiters;
+
+    uint8_t list;
+    uint16_t next_queued;
+
+    uint16_t *dependencies;
+    uint16_t dependency_count,
+             dependency_cap;
+    uint32_t visit;
 } rf_Resource;
 
 typedef struct rf_ResourceMaster {
@@ -142,52 +391,427 @@ typedef struct rf_ResourceMaster {
            is_loading,
            need_finish;
 
-    pthread_t         load_thread;
+    pthread_t         load_threads[RF_MTR_MAX_THREADS];
     pthread_mutex_t   mutex;
+    pthread_cond_t    ready_cond;
+    uint8_t thread_count,
+            running_threads,
+            started_threads,
+            active_threads,
+            loading_threads;
+
+    uint16_t ready_head,
+             ready_tail,
+             retry_head;
+
+    int16_t loader_cpus[RF_MTR_MAX_THREADS];
+    uint8_t loader_cpu_count;
+    int16_t numa_node;
+
+    rf_MTRParseFunc parse_func;
+    void *parse_user_data;
+    rf_MTRWaiter *fired_waiters;
+
+    uint8_t max_retries;
+    int64_t retry_backoff_ms,
+            timeout_ms,
+            next_retry_time,
+            next_deadline;
+
+    uint32_t visit_stamp;
+    uint16_t *visit_stack;
 
     uint16_t resource_count;
     rf_Resource *resources;
 } rf_ResourceMaster;
 
-inline void *_rf__mtr_resource_load_thread(void *resources) {
-    rf_ResourceMaster *r = (rf_ResourceMaster *)resources;
+inline int64_t _rf__mtr_time_ms(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec*1000 + t.tv_nsec/1000000;
+}
 
-    for(uint16_t i = 0; i < r->resource_count; i++) {
-        if(r->resources[i].need_load) {
-            pthread_mutex_lock(&r->mutex);
-            int8_t data_loaded = r->resources[i].data != 0;
-            pthread_mutex_unlock(&r->mutex);
+inline int8_t _rf__mtr_error_is_transient(int error) {
+    return error == EINTR  ||
+           error == EAGAIN ||
+           error == EBUSY  ||
+           error == EMFILE ||
+           error == ENFILE ||
+           error == EIO;
+}
 
-            if(!data_loaded) {
-                FILE *file = fopen(r->resources[i].filename, "rb");
-
-                if(file) {
-                    int64_t file_size;
-                    char *buffer;
-                    fseek(file, 0, SEEK_END);
-                    file_size = ftell(file);
-                    rewind(file);
-                    buffer = (char *)calloc(file_size + 1, sizeof(char));
-                    fread(buffer, file_size, 1, file);
-                    fclose(file);
-
-                    pthread_mutex_lock(&r->mutex);
-                    r->resources[i].data_len = file_size;
-                    r->resources[i].data = (void *)buffer;
-                    pthread_mutex_unlock(&r->mutex);
-                }
+inline void _rf__mtr_finish_locked(rf_ResourceMaster *r, rf_Resource *res, int8_t status) {
+    res->status = status;
+    while(res->waiters) {
+        rf_MTRWaiter *waiter = res->waiters;
+        res->waiters = waiter->next;
+        waiter->status = status;
+        waiter->next = r->fired_waiters;
+        r->fired_waiters = waiter;
+    }
+}
+
+inline void _rf__mtr_fire_waiters(rf_ResourceMaster *r) {
+    pthread_mutex_lock(&r->mutex);
+    rf_MTRWaiter *waiter = r->fired_waiters;
+    r->fired_waiters = NULL;
+    pthread_mutex_unlock(&r->mutex);
+
+    while(waiter) {
+        rf_MTRWaiter *next = waiter->next;
+        waiter->func(r, waiter->index, waiter->status, waiter->user_data);
+        waiter = next;
+    }
+}
+
+inline void _rf__mtr_unlink_retry_locked(rf_ResourceMaster *r, uint16_t index) {
+    uint16_t *link = &r->retry_head;
+    while(*link != index) {
+        link = &r->resources[*link].next_queued;
+    }
+    *link = r->resources[index].next_queued;
+    r->resources[index].list = _RF_MTR_LIST_NONE;
+}
+
+// appends a QUEUED resource to the FIFO loaders claim from, and wakes one
+// loader that's waiting for work
+inline void _rf__mtr_push_ready_locked(rf_ResourceMaster *r, uint16_t index) {
+    rf_Resource *res = r->resources + index;
+    if(res->list == _RF_MTR_LIST_READY) {
+        return;
+    }
+    if(res->list == _RF_MTR_LIST_RETRY) {
+        _rf__mtr_unlink_retry_locked(r, index);
+    }
+
+    res->list = _RF_MTR_LIST_READY;
+    res->next_queued = _RF_MTR_NO_RESOURCE;
+    if(r->ready_tail == _RF_MTR_NO_RESOURCE) {
+        r->ready_head = index;
+    }
+    else {
+        r->resources[r->ready_tail].next_queued = index;
+    }
+    r->ready_tail = index;
+    pthread_cond_signal(&r->ready_cond);
+}
+
+inline void _rf__mtr_push_retry_locked(rf_ResourceMaster *r, uint16_t index) {
+    rf_Resource *res = r->resources + index;
+    res->list = _RF_MTR_LIST_RETRY;
+    res->next_queued = r->retry_head;
+    r->retry_head = index;
+    if(!r->next_retry_time || res->retry_time < r->next_retry_time) {
+        r->next_retry_time = res->retry_time;
+    }
+}
+
+// moves retries that are due to the ready FIFO (dropping ones that finished
+// some other way) and works out when the next one is due
+inline void _rf__mtr_collect_retries_locked(rf_ResourceMaster *r, int64_t now) {
+    uint16_t index = r->retry_head;
+    r->retry_head = _RF_MTR_NO_RESOURCE;
+    r->next_retry_time = 0;
+    while(index != _RF_MTR_NO_RESOURCE) {
+        rf_Resource *res = r->resources + index;
+        uint16_t next = res->next_queued;
+        res->list = _RF_MTR_LIST_NONE;
+        if(res->status == RF_MTR_STATUS_QUEUED) {
+            if(res->retry_time <= now) {
+                _rf__mtr_push_ready_locked(r, index);
+            }
+            else {
+                _rf__mtr_push_retry_locked(r, index);
             }
+        }
+        index = next;
+    }
+}
 
-            pthread_mutex_lock(&r->mutex);
-            r->resources[i].need_load = 0;
-            pthread_mutex_unlock(&r->mutex);
+// pops the next resource to load off the ready FIFO, timing out any whose
+// deadline passed while they waited; -1 if there's nothing to load now
+inline int32_t _rf__mtr_claim_locked(rf_ResourceMaster *r) {
+    int64_t now = _rf__mtr_time_ms();
+    if(r->next_retry_time && now >= r->next_retry_time) {
+        _rf__mtr_collect_retries_locked(r, now);
+    }
+
+    while(r->ready_head != _RF_MTR_NO_RESOURCE) {
+        uint16_t index = r->ready_head;
+        rf_Resource *res = r->resources + index;
+        r->ready_head = res->next_queued;
+        if(r->ready_head == _RF_MTR_NO_RESOURCE) {
+            r->ready_tail = _RF_MTR_NO_RESOURCE;
+        }
+        res->list = _RF_MTR_LIST_NONE;
+
+        if(res->status != RF_MTR_STATUS_QUEUED) {
+            continue;
+        }
+        if(res->deadline && now >= res->deadline) {
+            res->error = ETIMEDOUT;
+            _rf__mtr_finish_locked(r, res, RF_MTR_STATUS_TIMED_OUT);
+            continue;
+        }
+        res->status = RF_MTR_STATUS_LOADING;
+        ++res->generation;
+        return index;
+    }
+    return -1;
+}
+
+// times out every queued, retrying or loading resource whose deadline has
+// passed, and works out when the next one is due
+inline void _rf__mtr_expire_locked(rf_ResourceMaster *r, int64_t now) {
+    r->next_deadline = 0;
+    for(uint16_t i = 0; i < r->resource_count; ++i) {
+        rf_Resource *res = r->resources + i;
+        if(!res->deadline ||
+           (res->status != RF_MTR_STATUS_QUEUED && res->status != RF_MTR_STATUS_LOADING)) {
+            continue;
+        }
+        if(now >= res->deadline) {
+            res->error = ETIMEDOUT;
+            _rf__mtr_finish_locked(r, res, RF_MTR_STATUS_TIMED_OUT);
+        }
+        else if(!r->next_deadline || res->deadline < r->next_deadline) {
+            r->next_deadline = res->deadline;
+        }
+    }
+}
+
+inline void _rf__mtr_request_locked(rf_ResourceMaster *r, uint16_t index) {
+    uint32_t stamp = ++r->visit_stamp;
+    uint32_t stack_size = 0;
+    int64_t now = _rf__mtr_time_ms();
+
+    r->resources[index].visit = stamp;
+    r->visit_stack[stack_size++] = index;
+
+    while(stack_size) {
+        rf_Resource *res = r->resources + r->visit_stack[--stack_size];
+
+        res->requested = 1;
+        if(!res->data &&
+           res->status != RF_MTR_STATUS_QUEUED &&
+           res->status != RF_MTR_STATUS_LOADING) {
+            res->status = RF_MTR_STATUS_QUEUED;
+            res->error = 0;
+            res->attempts = 0;
+            res->retry_time = 0;
+            res->deadline = r->timeout_ms > 0 ? now + r->timeout_ms : 0;
+            if(res->deadline && (!r->next_deadline || res->deadline < r->next_deadline)) {
+                r->next_deadline = res->deadline;
+            }
+            r->need_load = 1;
+            _rf__mtr_push_ready_locked(r, (uint16_t)(res - r->resources));
         }
+
+        for(uint16_t i = 0; i < res->dependency_count; ++i) {
+            uint16_t dep = res->dependencies[i];
+            if(r->resources[dep].visit != stamp) {
+                r->resources[dep].visit = stamp;
+                r->visit_stack[stack_size++] = dep;
+            }
+        }
+    }
+}
+
+inline void _rf__mtr_pin_thread(int16_t cpu) {
+#ifdef __linux__
+    unsigned long mask[_RF_MTR_MAX_CPUS / (8 * sizeof(unsigned long))] = { 0 };
+    if(cpu >= 0 && cpu < _RF_MTR_MAX_CPUS) {
+        mask[cpu / (8 * sizeof(unsigned long))] |= 1UL << (cpu % (8 * sizeof(unsigned long)));
+        syscall(SYS_sched_setaffinity, 0, sizeof(mask), mask);
+    }
+#else
+    (void)cpu;
+#endif
+}
+
+inline void _rf__mtr_prefer_numa_node(int16_t node) {
+#ifdef __linux__
+    unsigned long mask[_RF_MTR_MAX_NUMA_NODES / (8 * sizeof(unsigned long))] = { 0 };
+    if(node >= 0 && node < _RF_MTR_MAX_NUMA_NODES) {
+        mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+        syscall(SYS_set_mempolicy, _RF_MTR_MPOL_PREFERRED, mask, _RF_MTR_MAX_NUMA_NODES + 1);
     }
+#else
+    (void)node;
+#endif
+}
+
+inline void _rf__mtr_bind_numa_node(void *data, int64_t size, int16_t node) {
+#ifdef __linux__
+    unsigned long mask[_RF_MTR_MAX_NUMA_NODES / (8 * sizeof(unsigned long))] = { 0 };
+    uintptr_t page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = ((uintptr_t)data + page_size - 1) & ~(page_size - 1),
+              end = ((uintptr_t)data + size) & ~(page_size - 1);
+    if(node >= 0 && node < _RF_MTR_MAX_NUMA_NODES && end > start) {
+        mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+        syscall(SYS_mbind, start, end - start, _RF_MTR_MPOL_PREFERRED, mask,
+                _RF_MTR_MAX_NUMA_NODES + 1, _RF_MTR_MPOL_MF_MOVE);
+    }
+#else
+    (void)data;
+    (void)size;
+    (void)node;
+#endif
+}
+
+inline int16_t rf_mtr_current_numa_node(void) {
+#ifdef __linux__
+    unsigned int cpu = 0,
+                 node = 0;
+    if(!syscall(SYS_getcpu, &cpu, &node, NULL)) {
+        return (int16_t)node;
+    }
+#endif
+    return -1;
+}
+
+inline int _rf__mtr_read_file(const char *filename, int16_t numa_node, char **data, int64_t *data_len) {
+    FILE *file = fopen(filename, "rb");
+    if(!file) {
+        return errno ? errno : ENOENT;
+    }
+
+    int error = 0;
+    int64_t file_size = -1;
+    char *buffer = NULL;
+
+    if(!fseek(file, 0, SEEK_END)) {
+        file_size = ftell(file);
+    }
+    if(file_size < 0) {
+        error = errno ? errno : EIO;
+    }
+    else {
+        rewind(file);
+        buffer = (char *)calloc(file_size + 1, sizeof(char));
+        if(!buffer) {
+            error = ENOMEM;
+        }
+        else {
+            if(numa_node >= 0) {
+                _rf__mtr_bind_numa_node(buffer, file_size, numa_node);
+            }
+            if(file_size && fread(buffer, file_size, 1, file) != 1) {
+                error = ferror(file) && errno ? errno : EIO;
+                free(buffer);
+                buffer = NULL;
+            }
+        }
+    }
+    fclose(file);
+
+    *data = buffer;
+    *data_len = buffer ? file_size : 0;
+    return error;
+}
+
+inline int8_t _rf__mtr_load_current(rf_ResourceMaster *r, uint16_t index, uint32_t generation) {
+    pthread_mutex_lock(&r->mutex);
+    int8_t current = r->resources[index].status == RF_MTR_STATUS_LOADING &&
+                     r->resources[index].generation == generation;
+    pthread_mutex_unlock(&r->mutex);
+    return current;
+}
+
+inline void *_rf__mtr_resource_load_thread(void *resources) {
+    rf_ResourceMaster *r = (rf_ResourceMaster *)resources;
 
     pthread_mutex_lock(&r->mutex);
-    r->need_finish = 1;
+    uint8_t thread_index = r->started_threads++;
+    int16_t cpu = r->loader_cpu_count ? r->loader_cpus[thread_index % r->loader_cpu_count] : -1;
+    int16_t numa_node = r->numa_node;
     pthread_mutex_unlock(&r->mutex);
 
+    if(cpu >= 0) {
+        _rf__mtr_pin_thread(cpu);
+    }
+    if(numa_node >= 0) {
+        _rf__mtr_prefer_numa_node(numa_node);
+    }
+
+    while(1) {
+        pthread_mutex_lock(&r->mutex);
+
+        // with nothing to claim, wait as long as another loader is busy: its
+        // parse callback may add dependencies, which are pushed and signalled
+        int32_t index = _rf__mtr_claim_locked(r);
+        while(index < 0 && r->loading_threads) {
+            pthread_cond_wait(&r->ready_cond, &r->mutex);
+            index = _rf__mtr_claim_locked(r);
+        }
+        if(index < 0) {
+            if(!--r->active_threads) {
+                r->need_finish = 1;
+            }
+            pthread_mutex_unlock(&r->mutex);
+            _rf__mtr_fire_waiters(r);
+            break;
+        }
+        ++r->loading_threads;
+        int8_t data_loaded = r->resources[index].data != 0;
+        int16_t resource_numa_node = r->resources[index].numa_node;
+        uint32_t generation = r->resources[index].generation;
+        pthread_mutex_unlock(&r->mutex);
+
+        int64_t data_len = 0;
+        char *buffer = NULL;
+        int error = 0;
+
+        if(!data_loaded) {
+            error = _rf__mtr_read_file(r->resources[index].filename,
+                                       resource_numa_node != numa_node ? resource_numa_node : -1,
+                                       &buffer, &data_len);
+            if(!error && r->parse_func && _rf__mtr_load_current(r, (uint16_t)index, generation)) {
+                r->parse_func(r, (uint16_t)index, buffer, data_len, r->parse_user_data);
+            }
+        }
+
+        pthread_mutex_lock(&r->mutex);
+        rf_Resource *res = r->resources + index;
+        // a load that timed out (and maybe was requested and claimed again
+        // since) has nothing left to report
+        if(res->status != RF_MTR_STATUS_LOADING || res->generation != generation) {
+            free(buffer);
+        }
+        else if(error) {
+            res->error = error;
+            if(_rf__mtr_error_is_transient(error) && res->attempts < r->max_retries) {
+                int64_t backoff = r->retry_backoff_ms;
+                for(uint8_t i = 0; i < res->attempts && backoff < _RF_MTR_MAX_RETRY_BACKOFF; i++) {
+                    backoff *= 2;
+                }
+                res->retry_time = _rf__mtr_time_ms() +
+                                  (backoff < _RF_MTR_MAX_RETRY_BACKOFF ? backoff : _RF_MTR_MAX_RETRY_BACKOFF);
+                ++res->attempts;
+                res->status = RF_MTR_STATUS_QUEUED;
+                _rf__mtr_push_retry_locked(r, (uint16_t)index);
+            }
+            else {
+                _rf__mtr_finish_locked(r, res, RF_MTR_STATUS_FAILED);
+            }
+        }
+        else {
+            if(buffer) {
+                res->data_len = data_len;
+                res->data = (void *)buffer;
+            }
+            res->error = 0;
+            _rf__mtr_finish_locked(r, res, RF_MTR_STATUS_READY);
+        }
+        // the last busy loader lets the waiting ones re-check, and exit if
+        // nothing was added
+        if(!--r->loading_threads) {
+            pthread_cond_broadcast(&r->ready_cond);
+        }
+        pthread_mutex_unlock(&r->mutex);
+        _rf__mtr_fire_waiters(r);
+    }
+
     return NULL;
 }
 
@@ -199,60 +823,235 @@ inline rf_ResourceMaster rf_mtr_init(uint16_t resource_count, const char **filen
     r.need_finish = 0;
 
     r.mutex = PTHREAD_MUTEX_INITIALIZER;
+    r.ready_cond = PTHREAD_COND_INITIALIZER;
+    r.thread_count = 1;
+    r.running_threads = 0;
+    r.started_threads = 0;
+    r.active_threads = 0;
+    r.loading_threads = 0;
+
+    r.ready_head = _RF_MTR_NO_RESOURCE;
+    r.ready_tail = _RF_MTR_NO_RESOURCE;
+    r.retry_head = _RF_MTR_NO_RESOURCE;
+
+    r.loader_cpu_count = 0;
+    r.numa_node = -1;
+
+    r.parse_func = NULL;
+    r.parse_user_data = NULL;
+    r.fired_waiters = NULL;
+
+    r.max_retries = 0;
+    r.retry_backoff_ms = 0;
+    r.timeout_ms = 0;
+    r.next_retry_time = 0;
+    r.next_deadline = 0;
+
+    r.visit_stamp = 0;
+    r.visit_stack = (uint16_t *)calloc(resource_count, sizeof(uint16_t));
 
     r.resource_count = resource_count;
     r.resources = (rf_Resource *)calloc(resource_count, sizeof(rf_Resource));
     for(uint16_t i = 0; i < resource_count; ++i) {
         r.resources[i].filename = filenames[i];
+        r.resources[i].numa_node = -1;
     }
 
     return r;
 }
 
+inline void _rf__mtr_join_threads(rf_ResourceMaster *r) {
+    for(uint8_t i = 0; i < r->running_threads; i++) {
+        pthread_join(r->load_threads[i], NULL);
+    }
+}
+
 inline void rf_mtr_clean_up(rf_ResourceMaster *r) {
     if(r->is_loading) {
-        pthread_join(r->load_thread, NULL);
+        _rf__mtr_join_threads(r);
     }
     pthread_mutex_destroy(&r->mutex);
+    pthread_cond_destroy(&r->ready_cond);
 
     for(uint16_t i = 0; i < r->resource_count; i++) {
         free(r->resources[i].data);
+        free(r->resources[i].dependencies);
     }
     free(r->resources);
+    free(r->visit_stack);
+}
+
+inline void rf_mtr_set_thread_count(rf_ResourceMaster *r, uint8_t thread_count) {
+    if(!thread_count) {
+        thread_count = 1;
+    }
+    else if(thread_count > RF_MTR_MAX_THREADS) {
+        thread_count = RF_MTR_MAX_THREADS;
+    }
+    r->thread_count = thread_count;
+}
+
+inline void rf_mtr_set_parse_func(rf_ResourceMaster *r, rf_MTRParseFunc parse_func, void *user_data) {
+    pthread_mutex_lock(&r->mutex);
+    r->parse_func = parse_func;
+    r->parse_user_data = user_data;
+    pthread_mutex_unlock(&r->mutex);
+}
+
+inline void rf_mtr_set_loader_cpus(rf_ResourceMaster *r, const int16_t *cpus, uint8_t cpu_count) {
+    if(cpu_count > RF_MTR_MAX_THREADS) {
+        cpu_count = RF_MTR_MAX_THREADS;
+    }
+
+    pthread_mutex_lock(&r->mutex);
+    for(uint8_t i = 0; i < cpu_count; i++) {
+        r->loader_cpus[i] = cpus[i];
+    }
+    r->loader_cpu_count = cpu_count;
+    pthread_mutex_unlock(&r->mutex);
+}
+
+inline void rf_mtr_set_numa_node(rf_ResourceMaster *r, int16_t node) {
+    pthread_mutex_lock(&r->mutex);
+    r->numa_node = node;
+    pthread_mutex_unlock(&r->mutex);
+}
+
+inline void rf_mtr_set_resource_numa_node(rf_ResourceMaster *r, uint16_t index, int16_t node) {
+    pthread_mutex_lock(&r->mutex);
+    r->resources[index].numa_node = node;
+    pthread_mutex_unlock(&r->mutex);
+}
+
+inline void rf_mtr_set_retry_policy(rf_ResourceMaster *r, uint8_t max_retries, int64_t retry_backoff_ms, int64_t timeout_ms) {
+    pthread_mutex_lock(&r->mutex);
+    r->max_retries = max_retries;
+    r->retry_backoff_ms = retry_backoff_ms > 0 ? retry_backoff_ms : 0;
+    r->timeout_ms = timeout_ms;
+    pthread_mutex_unlock(&r->mutex);
 }
 
 inline void rf_mtr_update(rf_ResourceMaster *r) {
     if(r->is_loading) {
         int8_t finished = 0;
         if(!pthread_mutex_trylock(&r->mutex)) {
+            // a hung read never gets back to the queue, so deadlines are
+            // enforced here as well as when loaders claim work
+            int64_t now = _rf__mtr_time_ms();
+            if(r->next_deadline && now >= r->next_deadline) {
+                _rf__mtr_expire_locked(r, now);
+            }
             finished = r->need_finish;
             pthread_mutex_unlock(&r->mutex);
         }
 
         if(finished) {
-            pthread_join(r->load_thread, NULL);
-            r->need_load = 0;
+            _rf__mtr_join_threads(r);
+
+            pthread_mutex_lock(&r->mutex);
+            _rf__mtr_collect_retries_locked(r, _rf__mtr_time_ms());
+            r->need_load = r->ready_head != _RF_MTR_NO_RESOURCE;
+            pthread_mutex_unlock(&r->mutex);
+
             r->is_loading = 0;
             r->need_finish = 0;
         }
     }
     else {
-        if(r->need_load) {
-            if(r->is_loading) {
-                pthread_join(r->load_thread, NULL);
+        pthread_mutex_lock(&r->mutex);
+        int64_t now = _rf__mtr_time_ms();
+        if(r->next_deadline && now >= r->next_deadline) {
+            _rf__mtr_expire_locked(r, now);
+        }
+        int8_t need_load = r->need_load ||
+                           (r->next_retry_time && now >= r->next_retry_time);
+        if(need_load) {
+            // the new threads block on the mutex until the counts below
+            // only include the ones that actually started
+            uint8_t created = 0;
+            r->started_threads = 0;
+            for(uint8_t i = 0; i < r->thread_count; i++) {
+                if(!pthread_create(&r->load_threads[created], NULL, _rf__mtr_resource_load_thread, (void *)r)) {
+                    ++created;
+                }
+            }
+            r->active_threads = created;
+            r->running_threads = created;
+            if(created) {
+                r->need_load = 0;
+                r->is_loading = 1;
             }
-            r->is_loading = 1;
-            pthread_create(&r->load_thread, NULL, _rf__mtr_resource_load_thread, (void *)r);
         }
+        pthread_mutex_unlock(&r->mutex);
     }
+
+    _rf__mtr_fire_waiters(r);
 }
 
 inline void rf_mtr_request(rf_ResourceMaster *r, uint16_t index) {
-    r->resources[index].need_load = 1;
+    pthread_mutex_lock(&r->mutex);
+    _rf__mtr_request_locked(r, index);
+    pthread_mutex_unlock(&r->mutex);
+}
 
+inline void rf_mtr_add_dependency(rf_ResourceMaster *r, uint16_t index, uint16_t dependency) {
     pthread_mutex_lock(&r->mutex);
-    r->need_load = 1;
+    rf_Resource *res = r->resources + index;
+
+    for(uint16_t i = 0; i < res->dependency_count; i++) {
+        if(res->dependencies[i] == dependency) {
+            pthread_mutex_unlock(&r->mutex);
+            return;
+        }
+    }
+
+    if(res->dependency_count >= res->dependency_cap) {
+        res->dependency_cap = res->dependency_cap ? res->dependency_cap * 2 : 4;
+        res->dependencies = (uint16_t *)realloc(res->dependencies, res->dependency_cap * sizeof(uint16_t));
+    }
+    res->dependencies[res->dependency_count++] = dependency;
+
+    if(res->requested) {
+        _rf__mtr_request_locked(r, dependency);
+    }
+    pthread_mutex_unlock(&r->mutex);
+}
+
+inline int8_t _rf__mtr_status_locked(rf_ResourceMaster *r, uint16_t index) {
+    rf_Resource *res = r->resources + index;
+    if((res->status == RF_MTR_STATUS_QUEUED || res->status == RF_MTR_STATUS_LOADING) &&
+       res->deadline && _rf__mtr_time_ms() >= res->deadline) {
+        res->error = ETIMEDOUT;
+        _rf__mtr_finish_locked(r, res, RF_MTR_STATUS_TIMED_OUT);
+    }
+    return res->status;
+}
+
+inline int8_t rf_mtr_resource_status(rf_ResourceMaster *r, uint16_t index, int *error) {
+    pthread_mutex_lock(&r->mutex);
+    int8_t status = _rf__mtr_status_locked(r, index);
+    if(error) {
+        *error = r->resources[index].error;
+    }
     pthread_mutex_unlock(&r->mutex);
+    return status;
+}
+
+inline int8_t rf_mtr_wait(rf_ResourceMaster *r, uint16_t index, rf_MTRWaiter *waiter) {
+    pthread_mutex_lock(&r->mutex);
+    int8_t status = r->resources[index].status;
+    if(status == RF_MTR_STATUS_READY ||
+       status == RF_MTR_STATUS_FAILED ||
+       status == RF_MTR_STATUS_TIMED_OUT) {
+        pthread_mutex_unlock(&r->mutex);
+        return 0;
+    }
+    waiter->index = index;
+    waiter->status = status;
+    waiter->next = r->resources[index].waiters;
+    r->resources[index].waiters = waiter;
+    pthread_mutex_unlock(&r->mutex);
+    return 1;
 }
 
 inline int8_t rf_mtr_resource_ready(rf_ResourceMaster *r, uint16_t index) {
@@ -265,6 +1064,42 @@ inline int8_t rf_mtr_resource_ready(rf_ResourceMaster *r, uint16_t index) {
     return 0;
 }
 
+inline int8_t rf_mtr_dependencies_ready(rf_ResourceMaster *r, uint16_t index) {
+    int8_t ready = 1;
+
+    pthread_mutex_lock(&r->mutex);
+    uint32_t stamp = ++r->visit_stamp;
+    uint32_t stack_size = 0;
+
+    r->resources[index].visit = stamp;
+    r->visit_stack[stack_size++] = index;
+
+    while(stack_size) {
+        uint16_t current = r->visit_stack[--stack_size];
+        rf_Resource *res = r->resources + current;
+
+        int8_t status = _rf__mtr_status_locked(r, current);
+        if(status == RF_MTR_STATUS_FAILED || status == RF_MTR_STATUS_TIMED_OUT) {
+            ready = -1;
+            break;
+        }
+        if(status != RF_MTR_STATUS_READY) {
+            ready = 0;
+        }
+
+        for(uint16_t i = 0; i < res->dependency_count; ++i) {
+            uint16_t dep = res->dependencies[i];
+            if(r->resources[dep].visit != stamp) {
+                r->resources[dep].visit = stamp;
+                r->visit_stack[stack_size++] = dep;
+            }
+        }
+    }
+    pthread_mutex_unlock(&r->mutex);
+
+    return ready;
+}
+
 inline int8_t rf_mtr_grab_resource_data(rf_ResourceMaster *r, uint16_t index, void **data, int64_t *data_len) {
     pthread_mutex_lock(&r->mutex);
     if(r->resources[index].data) {
@@ -279,6 +1114,116 @@ inline int8_t rf_mtr_grab_resource_data(rf_ResourceMaster *r, uint16_t index, vo
     return 0;
 }
 
+#if defined(__cplusplus) && defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+
+struct rf_MTRExecutor {
+    virtual ~rf_MTRExecutor() {}
+    virtual void execute(std::coroutine_handle<> handle) = 0;
+};
+
+struct rf_MTRQueueExecutor : rf_MTRExecutor {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    std::coroutine_handle<> *handles = NULL;
+    uint32_t handle_count = 0,
+             handle_cap = 0;
+
+    ~rf_MTRQueueExecutor() override {
+        pthread_mutex_destroy(&mutex);
+        free(handles);
+    }
+
+    void execute(std::coroutine_handle<> handle) override {
+        pthread_mutex_lock(&mutex);
+        if(handle_count >= handle_cap) {
+            handle_cap = handle_cap ? handle_cap * 2 : 16;
+            handles = (std::coroutine_handle<> *)realloc((void *)handles, handle_cap * sizeof(std::coroutine_handle<>));
+        }
+        handles[handle_count++] = handle;
+        pthread_mutex_unlock(&mutex);
+    }
+
+    void run() {
+        pthread_mutex_lock(&mutex);
+        uint32_t count = handle_count;
+        pthread_mutex_unlock(&mutex);
+
+        for(uint32_t i = 0; i < count; i++) {
+            pthread_mutex_lock(&mutex);
+            std::coroutine_handle<> handle = handles[i];
+            pthread_mutex_unlock(&mutex);
+            handle.resume();
+        }
+
+        pthread_mutex_lock(&mutex);
+        for(uint32_t i = count; i < handle_count; i++) {
+            handles[i - count] = handles[i];
+        }
+        handle_count -= count;
+        pthread_mutex_unlock(&mutex);
+    }
+};
+
+typedef struct rf_MTRResult {
+    int8_t status;
+    int error;
+    void *data;
+    int64_t data_len;
+} rf_MTRResult;
+
+struct rf_MTRRequest {
+    rf_ResourceMaster *r;
+    uint16_t index;
+    rf_MTRExecutor *executor;
+    std::coroutine_handle<> handle;
+    rf_MTRWaiter waiter;
+
+    static void _wake(rf_ResourceMaster *, uint16_t, int8_t, void *user_data) {
+        rf_MTRRequest *request = (rf_MTRRequest *)user_data;
+        if(request->executor) {
+            request->executor->execute(request->handle);
+        }
+        else {
+            request->handle.resume();
+        }
+    }
+
+    bool await_ready() {
+        int8_t status = rf_mtr_resource_status(r, index, NULL);
+        return (status == RF_MTR_STATUS_READY && rf_mtr_resource_ready(r, index)) ||
+               status == RF_MTR_STATUS_FAILED ||
+               status == RF_MTR_STATUS_TIMED_OUT;
+    }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+        handle = h;
+        waiter.func = _wake;
+        waiter.user_data = this;
+        rf_mtr_request(r, index);
+        return rf_mtr_wait(r, index, &waiter);
+    }
+
+    rf_MTRResult await_resume() {
+        rf_MTRResult result = { 0, 0, NULL, 0 };
+        result.status = rf_mtr_resource_status(r, index, &result.error);
+        if(result.status == RF_MTR_STATUS_READY) {
+            rf_mtr_grab_resource_data(r, index, &result.data, &result.data_len);
+        }
+        return result;
+    }
+};
+
+inline rf_MTRRequest rf_mtr_async(rf_ResourceMaster *r, uint16_t index, rf_MTRExecutor *executor = NULL) {
+    rf_MTRRequest request;
+    request.r = r;
+    request.index = index;
+    request.executor = executor;
+    return request;
+}
+
+#endif
+
 #endif
 
 /*
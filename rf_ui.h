@@ -12,7 +12,8 @@
         input from the user (it only interprets input that you
         provide it).
 
-        This library has no dependencies.
+        It uses the CRT's realloc/free by default, but you
+        can change this (see CUSTOMIZATION section).
 
     WHAT IS IMMEDIATE MODE GUI?
 
@@ -82,43 +83,38 @@
         NOTE: I use "widget" and "element" interchangably, so
               keep that in mind!
 
-      * floating-point IDs
-            rf_ui uses floating-point (specifically double-sized)
-            IDs for each widget. This is done for a specific
-            reason.
+      * hashed IDs and the ID stack
+            rf_ui uses 64-bit integer IDs (rf_ui_id) for each
+            widget. An ID of 0 means "no widget".
 
-            Usually, to avoid large enums of IDs (or the like),
-            I #define a GEN_ID macro to generate a unique ID
-            that uses the __LINE__ macro to be generated.
+            IDs are made by hashing something that identifies
+            the widget: a label (rf_ui_get_id), a pointer
+            (rf_ui_get_id_ptr), or an integer such as a loop
+            index or __LINE__ (rf_ui_get_id_int).
 
-            This poses a problem, though, because there are
-            times when one wants to create elements in a loop,
-            like so:
+            The hash is seeded with the ID on top of the UI's
+            "ID stack". Pushing an ID (rf_ui_push_id) makes
+            every ID generated until the matching rf_ui_pop_id
+            unique to that scope, so the same label can be
+            reused in different panels, and widgets generated
+            in a loop don't collide:
 
                 for(int i = 0; i < 10; i++) {
-                    if(do_button(GEN_ID, x, y+i*h, w, h, "Button")) {
-                        // do something
-                    }
-                }
-
-            The problem is that GEN_ID will generate the same
-            ID for all buttons generated by the loop (which
-            effectively breaks the input system).
-
-            The advantage in using floating-point IDs is the
-            ability to treat the decimal portion of the number
-            as a "sub-ID"... like so:
-
-                for(int i = 0; i < 10; i++) {
-                    if(do_button(GEN_ID + (i/100.f), x, y+i*h, w, h, "Button")) {
-
+                    rf_ui_push_id(ui, rf_ui_get_id_int(ui, i));
+                    {
+                        if(do_button(rf_ui_get_id(ui, "Delete"), x, y+i*h, w, h)) {
+                            // delete item i
+                        }
+                        if(do_button(rf_ui_get_id(ui, "Rename"), x+w, y+i*h, w, h)) {
+                            // rename item i
+                        }
                     }
+                    rf_ui_pop_id(ui);
                 }
 
-            Notice how GEN_ID is being added to (i/100.f), which
-            is loop variant, to generate the ID for the widget.
-            This makes each widget have a unique ID, while also
-            not overlapping with IDs for other widgets.
+            Scopes can be nested up to RF_UI_ID_STACK_SIZE
+            deep (#define it before including this file to
+            change it). The stack is cleared by rf_ui_begin.
 
       * ui "focus"
             rf_ui provides the concept of a ui "focus" which is
@@ -129,6 +125,22 @@
             or something similar). Any non-focused elements can
             NOT be navigated to using the keyboard.
 
+            Focused widgets are recorded (with their rectangles)
+            in a list that grows as needed and is reset by
+            rf_ui_begin, so there's no limit on how many widgets
+            can be navigated with the keyboard.
+
+            The arrow controls (RF_UI_CONTROL_UP_PRESS etc.)
+            move focus to the nearest focused widget in that
+            direction, so grids and multi-column layouts
+            navigate the way they look. The rectangles are put
+            into a uniform grid when an arrow is pressed, so
+            finding the neighbor only looks at the cells around
+            the current widget, even with thousands of widgets
+            on screen. RF_UI_CONTROL_NEXT_PRESS and
+            RF_UI_CONTROL_PREV_PRESS (e.g. Tab/Shift+Tab) move
+            through widgets in the order they were submitted.
+
       * ui "focus" groups
             UI focus also includes the concept of "focus groups".
             These are most useful when, for example, the GUI
@@ -173,6 +185,59 @@
                 }
                 rf_ui_unfocus();
 
+      * retained widget state
+            Some widgets need to remember things between frames
+            (a scroll offset, whether a tree node is open, where
+            a text cursor is...). Instead of making the caller
+            keep track of that, a widget can call
+            rf_ui_get_state with its ID to get an
+            rf_UIWidgetState, which holds a few ints and floats
+            for the widget to use however it wants. It is zeroed
+            the first time it is requested.
+
+            The states are kept in an open-addressed hash table
+            inside of the rf_UIState, so getting one is O(1)
+            and doesn't allocate per widget. rf_ui_end throws
+            away the state of every widget that didn't request
+            its state during that frame, so widgets that stop
+            being submitted don't leak. States are stamped with
+            the frame they were last requested in rather than
+            cleared, and rf_ui_end only sweeps the table when
+            fewer states were requested than it holds, so a UI
+            whose widgets stay the same pays nothing for it.
+
+            NOTE: the returned pointer is only valid until the
+                  next call to rf_ui_get_state (the table
+                  might grow). rf_ui_find_state looks a state
+                  up without creating it (or keeping it alive).
+
+      * animations
+            rf_ui_animate eases a value towards a target over
+            time, so hover highlights, thumbs and panels can
+            move smoothly without the caller keeping track of
+            anything per widget:
+
+                float hover = rf_ui_animate(ui, rf_ui_hash("hover", 5, id),
+                                            ui->hot == id, 0.15f);
+                // blend between the normal and hot colors by hover
+
+            It returns the value as of the end of last frame.
+            When the target changes, the value eases (quickly
+            at first, then slowing down) from wherever it is to
+            the new target over the given duration in seconds;
+            a new animation starts at its target. Set
+            ui.delta_time to the time since the last frame
+            every frame (it's 1/60 by default).
+
+            Animations are stored by ID in flat arrays and all
+            of them are advanced together in rf_ui_end, in one
+            loop with no branches, so many animated widgets
+            cost little more than one. Like retained state,
+            animations that weren't requested during a frame
+            are thrown away, and while any of them is still
+            moving, rf_ui_end calls rf_ui_request_frame so the
+            UI doesn't go idle (see IDLE FRAMES AND DAMAGE).
+
     USAGE
 
         To use this library, you must #define RF_UI_IMPLEMENTATION
@@ -202,6 +267,33 @@
                 // ...
             }
 
+        When you're done with the UI, call rf_ui_clean_up to
+        free any memory it allocated:
+
+            rf_ui_clean_up(&ui);
+
+        You can have as many rf_UIStates as you like (say,
+        one per viewport); they don't share anything. An
+        rf_UIState is a few kilobytes, and only allocates
+        anything once it's used. To keep many of them
+        together, carve them out of a block of memory you
+        own with an rf_UIArena:
+
+            rf_UIArena arena = rf_ui_arena_init(memory, memory_size);
+            rf_UIState *viewport_ui = rf_ui_arena_push_state(&arena);
+
+        rf_ui_arena_push_state returns an initialized
+        rf_UIState (without copying one around), or NULL if
+        the memory is used up. Call rf_ui_clean_up on each
+        of them before you free the memory.
+
+        Per frame, rf_ui_begin and rf_ui_end don't clear
+        anything proportional to the size of the UI: the
+        frame counter is bumped, and retained state and
+        animations are only swept when something went away
+        (see retained widget state). A context with nothing
+        in it costs a few hundred nanoseconds a frame.
+
         The rf_UIState holds variables that track the input
         to be used in the UI. These are input-implementation
         agnostic, so you'll need to set them yourself each
@@ -244,6 +336,25 @@
 
             ui.controls[RF_UI_CONTROL_BACKSPACE] = key_press[KEY_BACKSPACE];
 
+            // text editing keys (see Line Edits/Text Boxes below);
+            // SELECT_HOLD extends selections (Shift), WORD_HOLD
+            // moves/deletes by word and makes HOME/END go to the
+            // start/end of the text (Ctrl)
+
+            ui.controls[RF_UI_CONTROL_DELETE] = key_press[KEY_DELETE];
+            ui.controls[RF_UI_CONTROL_HOME] = key_press[KEY_HOME];
+            ui.controls[RF_UI_CONTROL_END] = key_press[KEY_END];
+            ui.controls[RF_UI_CONTROL_SELECT_HOLD] = key_down[KEY_SHIFT];
+            ui.controls[RF_UI_CONTROL_WORD_HOLD] = key_down[KEY_CTRL];
+            ui.controls[RF_UI_CONTROL_SELECT_ALL] = key_down[KEY_CTRL] && key_press[KEY_A];
+            ui.controls[RF_UI_CONTROL_UNDO] = key_down[KEY_CTRL] && key_press[KEY_Z];
+            ui.controls[RF_UI_CONTROL_REDO] = key_down[KEY_CTRL] && key_press[KEY_Y];
+
+            // mouse wheel movement this frame, in pixels
+            // (positive scrolls content down)
+
+            ui.scroll_y = wheel_delta * 40;
+
             // this might seem cumbersome, but...
             // it is pretty powerful from the library user's perspective,
             // because you can do a lot to control each UI action.
@@ -251,13 +362,61 @@
             // for example, if I want Tab and Shift+Tab to also act as
             // navigation:
 
-            ui.controls[RF_UI_CONTROL_UP_PRESS] = key_press[KEY_UP] || (key_down[KEY_SHIFT] && key_press[KEY_TAB]);
-            ui.controls[RF_UI_CONTROL_DOWN_PRESS] = key_press[KEY_DOWN] || key_press[KEY_TAB];
+            ui.controls[RF_UI_CONTROL_PREV_PRESS] = key_down[KEY_SHIFT] && key_press[KEY_TAB];
+            ui.controls[RF_UI_CONTROL_NEXT_PRESS] = !key_down[KEY_SHIFT] && key_press[KEY_TAB];
+
+            // the arrow controls move focus spatially (to the
+            // nearest focused widget in that direction), while
+            // NEXT/PREV move through widgets in the order they
+            // were submitted (wrapping around).
+
+        Setting fields once per frame only keeps the last
+        state of each control, though; a click that starts and
+        ends between two frames is lost, and only one character
+        gets typed per frame. If your platform gives you input
+        as events, you can instead forward every one of them
+        (again, AFTER rf_ui_begin) and let rf_ui queue them:
+
+            rf_ui_begin(&ui);
+
+            while(poll_event(&e)) {
+                switch(e.type) {
+                    case MOUSE_MOVE:
+                        rf_ui_input_cursor(&ui, e.x, e.y, e.time);
+                        break;
+                    case MOUSE_BUTTON:
+                        rf_ui_input_control(&ui, RF_UI_CONTROL_LEFT_MOUSE, e.down, e.time);
+                        break;
+                    case KEY:
+                        rf_ui_input_control(&ui, control_for_key(e.key), e.down, e.time);
+                        break;
+                    case TEXT:
+                        rf_ui_input_text(&ui, e.codepoint, e.time);
+                        break;
+                    case WHEEL:
+                        rf_ui_input_scroll(&ui, e.delta * 40, e.time);
+                        break;
+                }
+            }
+
+        Widgets walk the queue in order, so every click and
+        every typed codepoint (UTF-8 encoded into line edits)
+        is seen no matter how many arrive in one frame. Queued
+        input also fills in the fields above (held controls and
+        the cursor carry over between frames, presses are
+        counted), so custom widgets reading them keep working;
+        ui.events holds the queue itself (rf_UIEvent, with the
+        cursor and mouse buttons as they were after each event)
+        until rf_ui_end clears it. Time stamps are passed
+        through as-is. Note that which widget is under the
+        cursor is still decided once per frame (see HIT
+        TESTING), so clicks land on what was hot at the end
+        of the previous frame.
 
         Once you've called rf_ui_begin and set up the input for the loop,
         you're all ready to go! You can call widget functions now.
 
-            if(rf_button(0, 32, 32, 128, 64)) {
+            if(rf_button(&ui, rf_ui_get_id(&ui, "Hello"), 32, 32, 128, 64)) {
                 printf("Hello, World!");
             }
 
@@ -286,6 +445,347 @@
         rf_button (and use that to handle input), while also
         doing rendering stuff in the same call.
 
+    LAYOUT
+
+        Instead of computing every widget's rectangle by hand,
+        you can let rf_ui's layout stack do it. A layout is a
+        row, a column, or a grid; rf_ui_layout_next hands out
+        the next rectangle in the current layout, which can
+        then be passed straight to a widget with
+        rf_ui_rect_args:
+
+            rf_ui_layout_begin(&ui, rf_ui_get_id(&ui, "panel"),
+                               RF_UI_LAYOUT_COLUMN,
+                               rf_ui_rect(0, 0, 400, 300));
+            {
+                rf_UIRect r = rf_ui_layout_next(&ui, rf_ui_pixels(24));
+                if(rf_button(&ui, rf_ui_get_id(&ui, "OK"), rf_ui_rect_args(r))) {
+                    // ...
+                }
+
+                rf_ui_layout_push(&ui, rf_ui_get_id(&ui, "row"),
+                                  RF_UI_LAYOUT_ROW, rf_ui_pixels(24));
+                {
+                    r = rf_ui_layout_next(&ui, rf_ui_fraction(1));
+                    value = rf_slider(&ui, rf_ui_get_id(&ui, "a"), rf_ui_rect_args(r), value);
+                    r = rf_ui_layout_next(&ui, rf_ui_pixels(64));
+                    rf_button(&ui, rf_ui_get_id(&ui, "Reset"), rf_ui_rect_args(r));
+                }
+                rf_ui_layout_pop(&ui);
+            }
+            rf_ui_layout_pop(&ui);
+
+        Sizes along a layout's direction can be:
+
+         - rf_ui_pixels(n): exactly n pixels
+
+         - rf_ui_fraction(n): a share of whatever the fixed
+           sizes and spacing leave over, proportional to n
+
+         - rf_ui_auto(): for nested layouts (via
+           rf_ui_layout_push/rf_ui_layout_grid), the size of
+           their content along their own direction (so a
+           column in a column, a row in a row, or a grid in
+           a column). Anything else acts like a fraction
+           of 1.
+
+        Children always fill a row/column in the other
+        direction. Grids hand out cells of cell_h height,
+        columns to a row.
+
+        Layout is resolved in a single pass with no
+        allocation: each layout caches its content size and
+        the totals of its fixed/fractional children in its
+        retained state, and uses last frame's values to
+        resolve fractions and auto sizes this frame. When a
+        UI's structure changes, sizes settle after one frame
+        (until then, fractions are cut short rather than
+        overflow the layout).
+
+        ui.layout_padding and ui.layout_spacing control the
+        padding inside and the spacing between children of
+        layouts opened after they're set (4 by default).
+        Layouts can be nested RF_UI_LAYOUT_STACK_SIZE deep.
+
+    HIT TESTING
+
+        Widgets that overlap are resolved by layer: only the
+        topmost widget under the cursor becomes hot. Widgets
+        are on layer 0 unless you put them somewhere else
+        with rf_ui_push_layer/rf_ui_pop_layer; higher layers
+        are on top, and within a layer, widgets submitted
+        later are on top (like they'd be drawn):
+
+            rf_ui_push_layer(&ui, 1);
+            {
+                // popup widgets here block the ones under them
+            }
+            rf_ui_pop_layer(&ui);
+
+        Widgets outside of the current clip rectangle (see
+        DRAW LISTS) can't be hit either.
+
+        During the frame, each widget only checks whether the
+        cursor is over it and keeps track of the best
+        candidate so far; the winner is picked in rf_ui_end
+        and becomes hot for the NEXT frame. This means widgets
+        can be submitted in any order, at the cost of a frame
+        of latency on hover.
+
+        A panel or popup background that should block the
+        widgets under it (without being a widget itself) can
+        call rf_ui_hit_rect with its own id and rect. Custom
+        widgets should use rf_ui_hit_rect in place of checking
+        the cursor themselves; it returns 1 if the widget is
+        hot. Layers can be nested RF_UI_LAYER_STACK_SIZE deep.
+
+    DRAW LISTS
+
+        rf_ui can optionally record what its widgets look
+        like into an rf_UIDrawList, a compact, renderer-
+        agnostic list of commands (rects, lines and text
+        runs, each tagged with a clip rectangle):
+
+            rf_UIDrawList draw_list = rf_ui_draw_list_init();
+            rf_ui_set_draw_list(&ui, &draw_list);
+
+        Every rf_ui_begin clears the list. Widgets add
+        commands tagged with an RF_UI_STYLE_ and
+        RF_UI_DRAW_HOT/RF_UI_DRAW_ACTIVE flags, colored from
+        draw_list.colors[style][normal/hot/active] (change
+        those to restyle everything). You can add your own
+        commands with rf_ui_draw_rect, rf_ui_draw_line and
+        rf_ui_draw_text, and clip everything between
+        rf_ui_push_clip and rf_ui_pop_clip to a rectangle.
+        Clips nest RF_UI_CLIP_STACK_SIZE deep; pushes past
+        that keep the innermost clip that fit, and are
+        still matched by their pops.
+
+        A front-end can walk draw_list.commands itself, or
+        call rf_ui_build_vertices after rf_ui_end to turn
+        the whole list into vertices/indices, batched by
+        clip rectangle:
+
+            rf_ui_build_vertices(&draw_list, white_u, white_v,
+                                 glyph_func, font);
+
+            for(uint32_t i = 0; i < draw_list.batch_count; i++) {
+                rf_UIDrawBatch *b = draw_list.batches + i;
+                set_scissor(b->clip_x, b->clip_y, b->clip_w, b->clip_h);
+                draw_indexed(draw_list.vertices, draw_list.indices + b->index_offset,
+                             b->index_count);
+            }
+
+        Everything is drawn with one texture; white_u and
+        white_v should point at a white texel of it (used
+        for rects and lines). glyph_func is called for every
+        codepoint of every text run to get its quad and
+        UVs; text is skipped if it's NULL.
+
+        Call rf_ui_draw_list_clean_up when you're done with
+        a draw list.
+
+    IDLE FRAMES AND DAMAGE
+
+        After rf_ui_end, ui.idle is 1 if running another frame
+        with no new input couldn't change anything: nothing
+        was pressed or typed, the cursor and held controls
+        didn't change, hot/active/focus didn't change and (with
+        a draw list) nothing was drawn differently. A host
+        loop can use it to stop spinning when the UI is
+        static:
+
+            rf_ui_end(&ui);
+            if(ui.idle) {
+                wait_for_input();   // e.g. SDL_WaitEvent
+            }
+
+        Note that hovering takes effect a frame late (see HIT
+        TESTING), so it takes a frame with no input after the
+        cursor stops moving for the UI to become idle. If
+        something outside of the input will change what you
+        draw (a timer, data loaded in the background, an
+        animation), call rf_ui_request_frame to keep the
+        current frame from counting as idle.
+
+        With a draw list, rf_ui_end also works out which parts
+        of the screen changed since the last frame. Every
+        command is hashed (geometry, color, style, clip and
+        text); commands that were only drawn this frame or
+        only drawn last frame add their bounds (clipped) to
+        draw_list.damage, which holds up to
+        RF_UI_MAX_DAMAGE_RECTS rectangles (overlapping ones
+        are merged, and when it runs out of room, the rect
+        that grows the least absorbs the new one):
+
+            for(uint32_t i = 0; i < draw_list.damage_count; i++) {
+                // repaint draw_list.damage[i]
+            }
+
+        damage_count is 0 when nothing changed. Text bounds
+        come from ui.text_width_func and ui.line_height (see
+        Text Boxes). The comparison doesn't look at draw
+        order, so if you only reorder overlapping commands,
+        repaint everything.
+
+    RECORDING AND REPLAY
+
+        rf_ui can record the input it's given and play it
+        back later, to reproduce a bug or to benchmark a real
+        session without a window. Once a frame's input is set
+        up (after rf_ui_begin and your input code, before any
+        widgets), call rf_ui_record_frame:
+
+            rf_UIRecording rec = rf_ui_recording_init();
+
+            rf_ui_begin(&ui);
+            // ...set up input...
+            rf_ui_record_frame(&ui, &rec);
+            // ...widgets...
+            rf_ui_end(&ui);
+
+        It saves the cursor, scroll, char input, every
+        control, the event queue and ui.delta_time (so key
+        repeat and animations replay at the recorded pace). To play frame i back,
+        call rf_ui_replay_frame in place of your input code;
+        it replaces the frame's input with the recorded one
+        and returns 0 when there are no frames left:
+
+            rf_ui_begin(&ui);
+            if(!rf_ui_replay_frame(&ui, &rec, i++)) {
+                // done
+            }
+            // ...widgets...
+            rf_ui_end(&ui);
+
+        Replaying gives the same results as long as the UI
+        code does the same thing each frame (it doesn't
+        depend on wall-clock time, say), starting from a
+        fresh rf_UIState.
+
+        rf_ui_recording_save serializes a recording into a
+        buffer allocated with RF_UI_REALLOC (free it with
+        RF_UI_FREE) and returns its size;
+        rf_ui_recording_load reads one back, returning 0 if
+        the data isn't a valid recording. The format is
+        little-endian and doesn't depend on the compiler,
+        and recordings keep working when controls are added.
+        Call rf_ui_recording_clean_up when you're done.
+
+        bench/rf_ui_bench.cpp replays sessions against large
+        synthetic UIs and reports per-frame time and
+        allocations.
+
+    PARALLEL PANELS
+
+        Independent parts of a UI (panels) can be built on
+        different threads. Each panel is an rf_UIState of its
+        own (made with rf_ui_init, and with its own draw list
+        if the main UI has one), kept from frame to frame so
+        it can hold its widgets' retained state. On the main
+        thread, after rf_ui_begin and input, call
+        rf_ui_panel_begin for each panel, then build the
+        panels on any threads you like, and call rf_ui_end
+        once they're all done:
+
+            rf_ui_begin(&ui);
+            // ...input...
+            for(int i = 0; i < panel_count; i++) {
+                rf_ui_panel_begin(&ui, &panels[i], rf_ui_get_id_int(&ui, i));
+            }
+
+            // on worker threads:
+            build_panel(&panels[i]);    // widgets take &panels[i]
+
+            // back on the main thread, after joining:
+            rf_ui_end(&ui);
+
+        rf_ui_panel_begin copies the frame's input and
+        interaction state into the panel, so a thread only
+        ever touches its own panel, with no locking. The ID
+        passed to it is pushed onto the panel's ID stack, so
+        widget IDs in different panels don't collide.
+
+        The one thing panels do share is the text measurer:
+        ui.text_width_func is called on whichever thread
+        builds the panel, so if panels run on several threads
+        it must be safe to call concurrently. rf_font's isn't
+        (a font caches glyphs and widths as it measures), so
+        give each panel a measurer of its own instead, set
+        once after rf_ui_init; rf_ui_panel_begin only copies
+        the main UI's measurer into panels that have none:
+
+            // fonts can share the same .ttf data
+            rf_font_init(&panel_fonts[i], ttf_data, ttf_size, 64, 64);
+            panel_faces[i] = rf_font_face(&panel_fonts[i], 16);
+            panels[i].text_width_func = rf_font_text_width;
+            panels[i].text_width_user = &panel_faces[i];
+
+        rf_ui_end merges the panels in the order
+        rf_ui_panel_begin was called, no matter which thread
+        finished first: their draw commands come after the
+        main UI's own (so they're drawn on top), their focus
+        items come after its own (so that's the keyboard
+        focus order), and hit testing works as though every
+        widget had been built on one thread in that order
+        (layers still win). Don't call rf_ui_end on a panel
+        yourself. Clean panels up with rf_ui_clean_up.
+
+    SEMANTIC TREE
+
+        For test automation (and accessibility layers), a UI
+        can also fill in a flat tree describing what was
+        built this frame, so tests can find widgets by ID or
+        by label instead of by screen position:
+
+            rf_UIAccessTree tree = rf_ui_access_tree_init();
+            rf_ui_set_access_tree(&ui, &tree);
+
+            // while building, name widgets that have no label
+            rf_ui_access_label(ui, "Save");
+            if(rf_button(ui, rf_ui_get_id(ui, "save"), x, y, w, h)) { ... }
+
+            // after rf_ui_end
+            const rf_UIAccessNode *save = rf_ui_access_find_label(&tree, "Save");
+            rf_ui_input_mouse_move(&ui, save->rect.x + 1, save->rect.y + 1, time);
+
+        Every rf_ui_begin clears the tree. Each widget adds
+        a node with its ID, an RF_UI_ROLE_, its rectangle,
+        RF_UI_ACCESS_ flags (hot, active, hidden when it's
+        outside the clip rectangle, expanded for open tree
+        nodes and windows), its value (a slider's or drag's
+        value, a list's or scroll region's scroll offset,
+        1 for a button or tree leaf on the frame it's
+        clicked) and its label and text (a line edit's
+        contents), which are NUL-terminated strings in
+        tree.text at label_offset and text_offset. A text
+        box's contents aren't copied; read its
+        rf_UITextBuffer. Tree nodes and windows are labelled
+        with their label and title; rf_ui_access_label
+        labels the next widget built, overriding those.
+
+        Nodes are in the order widgets were built, and each
+        has the index + 1 of its parent (0 at the top):
+        lists, scroll regions, open tree nodes, windows
+        whose content is built and rf_drag_float_n's group
+        contain the widgets built inside them. A window's
+        rectangle is its title bar, or its tab when docked.
+        Culled widgets are still there (flagged hidden), but
+        the children of a closed tree node, of an offscreen
+        subtree that was skipped or of a window that's
+        collapsed, closed or behind another tab are not.
+
+        rf_ui_end indexes the tree by ID and by label, so
+        rf_ui_access_find and rf_ui_access_find_label are
+        a hash lookup each (with several nodes labelled the
+        same, the first is found). They return NULL before
+        the first rf_ui_end and between rf_ui_begin and
+        rf_ui_end. With no tree set, widgets skip all of
+        this; with one, building it costs a few stores and
+        a copy of each label per widget. Panels (see
+        PARALLEL PANELS) given their own trees are merged
+        in with the rest of their output, at the top level.
+
     DEFAULTLY SUPPORTED WIDGETS
 
       * Buttons
@@ -297,7 +797,7 @@
              - a pointer to the rf_UIState with which it should
                be used
 
-             - a (should be) unique floating-point ID
+             - a unique rf_ui_id
 
              - x, y coordinates of the button
 
@@ -313,7 +813,7 @@
              - a pointer to the rf_UIState with which it should
                be used
 
-             - a (should be) unique floating-point ID
+             - a unique rf_ui_id
 
              - x, y coordinates of the slider
 
@@ -322,6 +822,40 @@
              - a float that holds the current [0-1] value of
                the slider
 
+            With keyboard focus, holding LEFT/RIGHT moves it by
+            1% at first, then faster the longer they're held
+            (by time, not frames, so it's the same at any frame
+            rate; see ui.delta_time).
+
+      * Value Widgets
+
+            rf_slider_range is a slider over [min, max] that
+            shows its value. rf_drag_float and rf_drag_int
+            are fields that change by speed per pixel the
+            cursor is dragged (a tenth of that while
+            SELECT_HOLD is held, for fine adjustment), and
+            rf_drag_float_n edits an array of floats (a
+            vector or color) as a row of drag fields:
+
+                pos.x = rf_drag_float(ui, rf_ui_get_id(ui, "x"), rf_ui_rect_args(r),
+                                      pos.x, 0.01f, 0, 0, 2);
+                rf_drag_float_n(ui, rf_ui_get_id(ui, "color"), rf_ui_rect_args(r2),
+                                color, 4, 0.005f, 0, 1, 3);
+
+            min >= max means no limits. Drags and held keys
+            work out the value from what it was when they
+            started, rather than adding a small step every
+            frame, so dragging back to where you started gives
+            back exactly the same value. Keys step by speed
+            (1 for ints) and speed up like sliders.
+
+            Values are shown with the given number of decimals
+            (up to 9), formatted by rf_ui_format_float and
+            rf_ui_format_int into text in the draw list; these
+            don't use the CRT and are skipped entirely when
+            there's no draw list. You can call them yourself
+            with a buffer of RF_UI_FORMAT_SIZE bytes.
+
       * Line Edits
 
             Line-Edits are created/handled using the rf_line_edit
@@ -332,7 +866,7 @@
              - a pointer to the rf_UIState with which it should
                be used
 
-             - a (should be) unique floating-point ID
+             - a unique rf_ui_id
 
              - x, y coordinates of the line-edit
 
@@ -341,8 +875,260 @@
              - a char * pointing to a character array to be
                modified by the widget
 
-             - an unsigned int that holds the maximum number
-               of characters that the text can hold
+             - an unsigned int that holds the size of the
+               character array (the text is kept
+               null-terminated, so it holds at most one less
+               byte than that)
+
+            Clicking a line edit places the cursor, dragging
+            selects, and while it is active the arrow, HOME,
+            END, DELETE, SELECT_ALL, UNDO and REDO controls
+            edit it (with SELECT_HOLD and WORD_HOLD as
+            modifiers). The text is UTF-8. While it's active,
+            the text lives in ui.edit_buffer (see Text Boxes)
+            and is copied back into your array whenever it
+            changes; if you change the array yourself, the
+            buffer picks it up (and loses its undo history).
+            Active text widgets use up the LEFT/RIGHT press
+            controls, so they don't move keyboard focus.
+
+      * Text Boxes
+
+            rf_text_box is a multi-line editor over an
+            rf_UITextBuffer that you own:
+
+                rf_UITextBuffer doc = rf_ui_text_init();
+                rf_ui_text_set(&doc, text, text_len);
+
+                if(rf_text_box(ui, rf_ui_get_id(ui, "doc"), x, y, w, h, &doc)) {
+                    // the text changed this frame
+                }
+
+                rf_ui_text_clean_up(&doc);
+
+            It returns 1 if the text changed this frame. On
+            top of what line edits do, UP/DOWN move between
+            lines, ACTIVATE inserts a newline and the mouse
+            wheel scrolls it.
+
+            An rf_UITextBuffer is a gap buffer: the text is
+            kept in one array with a hole at the cursor, so
+            typing and deleting only move the bytes between
+            the old and new cursor positions. It also keeps
+            the start of every line in a sorted array that
+            edits patch in place, so finding a line (or the
+            line of a position) is a binary search, and the
+            text box only looks at the lines it shows. That
+            keeps megabyte-sized documents responsive.
+
+            You can also edit buffers directly with
+            rf_ui_text_insert (replaces the selection),
+            rf_ui_text_delete, rf_ui_text_move (with an
+            RF_UI_TEXT_ motion), rf_ui_text_select,
+            rf_ui_text_undo and rf_ui_text_redo. Every edit
+            is recorded for undo; consecutive typing is
+            undone as one step. cursor and anchor are byte
+            offsets (the selection is between them), and
+            version changes with every edit. Use
+            rf_ui_text_copy to get text out (for a
+            clipboard, say), or rf_ui_text_span to get a
+            contiguous pointer to part of it (this can move
+            the gap, so it's only valid until the next edit).
+
+            Text is measured with ui.text_width_func (given
+            ui.text_width_user, a run of UTF-8 text and its
+            length in bytes) if it's set, otherwise every
+            codepoint is RF_UI_CHAR_WIDTH wide. Lines are
+            ui.line_height apart (RF_UI_LINE_HEIGHT by
+            default). rf_font.h provides a text_width_func
+            and glyph_func for TrueType fonts, with cached
+            measurements and a glyph atlas. With parallel
+            panels, text_width_func must be safe to call
+            from several threads at once, or each panel
+            needs its own (see PARALLEL PANELS).
+
+      * Lists and Tables
+
+            Lists are virtualized: rf_ui_list_begin takes a
+            row count and a row height, works out which rows
+            are visible at the list's scroll offset (kept in
+            its retained state, changed with the mouse wheel
+            or by dragging the scrollbar), and returns them as
+            [view.first, view.last). Only submit those rows, so
+            a list with 100,000 rows costs as much per frame as
+            one with 20:
+
+                rf_UIListView view;
+                rf_ui_list_begin(ui, rf_ui_get_id(ui, "files"),
+                                 x, y, w, h, file_count, 20, &view);
+                for(uint32_t i = view.first; i < view.last; i++) {
+                    rf_UIRect r = rf_ui_list_row(ui, &view, i);
+                    if(rf_button(ui, rf_ui_get_id_int(ui, i), rf_ui_rect_args(r))) {
+                        // file i was clicked
+                    }
+                }
+                rf_ui_list_end(ui, &view);
+
+            rf_ui_list_begin pushes the list's ID and a clip
+            rectangle, so IDs generated for rows are unique to
+            the list; rf_ui_list_end pops both. It returns 0 if
+            no rows are visible.
+
+            Tables work the same way (rf_ui_table_begin,
+            rf_ui_table_end), but also take a column count and
+            an optional array of column widths (NULL for equal
+            widths); rf_ui_table_cell gives the rectangle of a
+            cell.
+
+      * Scroll Regions
+
+            For content that isn't made of equal rows, use a
+            scroll region. rf_ui_scroll_begin clips to its
+            rectangle and opens a column layout (see LAYOUT)
+            that's moved up by the scroll offset, so content
+            laid out with rf_ui_layout_next scrolls by itself;
+            content placed by hand can use view.x, view.y and
+            view.scroll:
+
+                rf_UIScrollView view;
+                rf_ui_scroll_begin(ui, rf_ui_get_id(ui, "settings"),
+                                   x, y, w, h, 0, &view);
+                for(int i = 0; i < setting_count; i++) {
+                    rf_UIRect r = rf_ui_layout_next(ui, rf_ui_pixels(24));
+                    values[i] = rf_slider(ui, rf_ui_get_id_int(ui, i), rf_ui_rect_args(r), values[i]);
+                }
+                rf_ui_scroll_end(ui, &view);
+
+            Pass the content's height, or 0 to use however
+            much the layout took up last frame. Like lists,
+            scroll regions push their ID and can be nested.
+
+            Lists and scroll regions keep scrolling for a few
+            frames after the wheel moves, slowing down by a
+            factor of RF_UI_SCROLL_FRICTION every frame (the
+            wheel distance is covered in total). They call
+            rf_ui_request_frame while they're moving, so the
+            UI doesn't go idle.
+
+            Buttons, sliders, line edits and text boxes that
+            are entirely outside the current clip rectangle
+            (of a list, scroll region or rf_ui_push_clip) are
+            culled: they're still added to the keyboard focus
+            list, but skip hit testing, input and drawing, so
+            a long scroll region mostly costs what's visible.
+            A widget that's hot or active is never culled.
+
+      * Trees
+
+            Tree nodes are rows in the current column layout
+            (usually a scroll region's), indented by
+            RF_UI_TREE_INDENT per level. Clicking one opens or
+            closes it. rf_ui_tree_push returns 1 if the node's
+            children should be submitted, followed by
+            rf_ui_tree_pop; rf_ui_tree_leaf adds a row with no
+            children and returns 1 when it's clicked:
+
+                void show(rf_UIState *ui, Node *node) {
+                    rf_ui_id id = rf_ui_get_id_ptr(ui, node);
+                    if(!node->child_count) {
+                        if(rf_ui_tree_leaf(ui, id, node->name)) {
+                            // node was clicked
+                        }
+                    }
+                    else if(rf_ui_tree_push(ui, id, node->name)) {
+                        for(int i = 0; i < node->child_count; i++) {
+                            show(ui, node->children[i]);
+                        }
+                        rf_ui_tree_pop(ui);
+                    }
+                }
+
+            Children of a closed node are never looked at.
+            Every open node also remembers how much of the
+            layout its children took up, and if that whole
+            span is outside the clip rectangle, rf_ui_tree_push
+            moves the layout past it and returns 0 without
+            the children being visited. So scrolling through a
+            tree of hundreds of thousands of nodes costs about
+            as much as the nodes on screen (plus their
+            siblings, so very wide levels are still better off
+            in a list). The span is last frame's: a subtree
+            that changed while it was skipped settles once it
+            scrolls into view. Subtrees aren't skipped while
+            one of their widgets is active or while keyboard
+            focus is being moved.
+
+            Open nodes stay open (even ones that weren't
+            submitted for a while) until they're closed;
+            rf_ui_tree_is_open and rf_ui_tree_set_open get and
+            set that by ID. Trees can be nested
+            RF_UI_TREE_STACK_SIZE deep (and the ID stack has
+            to be that deep too, since each open node pushes
+            its ID).
+
+      * Windows and Docking
+
+            rf_ui_window_begin makes a window with a title bar
+            that can be dragged, a box that collapses it, a
+            grip that resizes it, and (if it's given a
+            pointer to an "open" flag) a box that closes it.
+            The rectangle is only where it starts out; after
+            that its position and size are retained. It
+            returns 1 if the window's content should be
+            submitted, in which case it's clipped to the
+            window and laid out in a column layout (like a
+            scroll region's), up to rf_ui_window_end:
+
+                rf_UIWindow window;
+                if(rf_ui_window_begin(ui, rf_ui_get_id(ui, "Scene"), "Scene",
+                                      20, 20, 300, 400, &scene_open, &window)) {
+                    // content, e.g. a scroll region with a tree
+                    rf_ui_window_end(ui, &window);
+                }
+
+            Windows that are collapsed, closed (*open is 0)
+            or docked behind another tab return 0, so none of
+            their content is built, however big it is.
+
+            Windows are on layers above the one they're begun
+            in, ordered by when they were last clicked, and
+            rf_ui_end moves their draw commands into that
+            order too, so they can be submitted in any order.
+            Put popups that should cover windows on a layer
+            above all of them.
+
+            rf_ui_dock_space declares a rectangle windows can
+            be docked into. Dropping a window's title bar on
+            it docks the window as a tab; only the selected
+            tab's content is built, and dragging a tab out of
+            the tab bar floats the window again. A dock space
+            has to be declared each frame before the windows
+            docked in it (a window whose dock space is
+            missing floats where it was).
+
+    CUSTOMIZATION
+
+        #define RF_UI_REALLOC and RF_UI_FREE to be the
+        identifiers of functions of your choosing to
+        stop rf_ui from using the CRT. They must have
+        the forms:
+
+            void *realloc_func(void *data, size_t n)
+            void free_func(void *data)
+
+        Both should behave like their CRT counterparts
+        (RF_UI_REALLOC must accept NULL and keep the
+        old contents, RF_UI_FREE must accept NULL).
+
+        #define RF_UI_SCROLL_FRICTION (0.75f by default) to
+        change how quickly scrolling slows down; 0 makes
+        the wheel scroll instantly, with no momentum.
+
+        #define RF_UI_KEY_REPEAT_RATE (20 by default) to set how
+        many steps a second held keys start out moving
+        sliders and value widgets by, and RF_UI_DRAG_FINE
+        (0.1f by default) to scale drags with SELECT_HOLD
+        held.
 
     LICENSE INFORMATION IS AT THE END OF THE FILE
 */
@@ -350,14 +1136,88 @@
 #ifndef _RF_UI_H
 #define _RF_UI_H
 
-#ifndef RF_UI_MAX_ELEMENTS
-#define RF_UI_MAX_ELEMENTS 1000
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef RF_UI_REALLOC
+#include <stdlib.h>
+#define RF_UI_REALLOC realloc
+#endif
+
+#ifndef RF_UI_FREE
+#include <stdlib.h>
+#define RF_UI_FREE free
+#endif
+
+#ifndef RF_UI_ID_STACK_SIZE
+#define RF_UI_ID_STACK_SIZE 64
+#endif
+
+#ifndef RF_UI_CLIP_STACK_SIZE
+#define RF_UI_CLIP_STACK_SIZE 32
+#endif
+
+#ifndef RF_UI_LAYOUT_STACK_SIZE
+#define RF_UI_LAYOUT_STACK_SIZE 32
+#endif
+
+#ifndef RF_UI_SCROLLBAR_SIZE
+#define RF_UI_SCROLLBAR_SIZE 10
+#endif
+
+#ifndef RF_UI_SCROLL_FRICTION
+#define RF_UI_SCROLL_FRICTION 0.75f
+#endif
+
+#ifndef RF_UI_LAYER_STACK_SIZE
+#define RF_UI_LAYER_STACK_SIZE 16
+#endif
+
+#ifndef RF_UI_TREE_STACK_SIZE
+#define RF_UI_TREE_STACK_SIZE 32
+#endif
+
+#ifndef RF_UI_TREE_INDENT
+#define RF_UI_TREE_INDENT 16
 #endif
 
-#define _rf__ui_id_equ(id1, id2) ((int)(id1 * 10000) == (int)(id2 * 10000))
+#ifndef RF_UI_KEY_REPEAT_RATE
+#define RF_UI_KEY_REPEAT_RATE 20
+#endif
+
+#ifndef RF_UI_DRAG_FINE
+#define RF_UI_DRAG_FINE 0.1f
+#endif
+
+#define RF_UI_FORMAT_SIZE 32
+
+#ifndef RF_UI_CHAR_WIDTH
+#define RF_UI_CHAR_WIDTH 8
+#endif
+
+#ifndef RF_UI_LINE_HEIGHT
+#define RF_UI_LINE_HEIGHT 16
+#endif
+
+#ifndef RF_UI_MAX_DAMAGE_RECTS
+#define RF_UI_MAX_DAMAGE_RECTS 8
+#endif
+
+#ifndef RF_UI_ACCESS_STACK_SIZE
+#define RF_UI_ACCESS_STACK_SIZE 64
+#endif
+
+#define _RF_UI_STATE_START_CAP 64
+#define _RF_UI_ARRAY_START_CAP 64
+#define _RF_UI_ARENA_ALIGN 16
+#define _RF_UI_TEXT_NO_COLUMN 0xffffffff
+#define _RF_UI_WINDOW_PLACED    (1 << 0)
+#define _RF_UI_WINDOW_COLLAPSED (1 << 1)
+
 #define _rf__ui_cursor_over(ui, x, y, w, h) (ui->cursor_x >= x && ui->cursor_x <= x+w && ui->cursor_y >= y && ui->cursor_y <= y+h)
+#define _rf__ui_point_over(px, py, x, y, w, h) ((px) >= (x) && (px) <= (x)+(w) && (py) >= (y) && (py) <= (y)+(h))
 
-typedef double rf_ui_id;
+typedef uint64_t rf_ui_id;
 
 enum {
     RF_UI_CONTROL_LEFT_MOUSE,
@@ -372,30 +1232,599 @@ enum {
     RF_UI_CONTROL_RIGHT_HOLD,
     RF_UI_CONTROL_ACTIVATE,
     RF_UI_CONTROL_BACKSPACE,
+    RF_UI_CONTROL_NEXT_PRESS,
+    RF_UI_CONTROL_PREV_PRESS,
+    RF_UI_CONTROL_DELETE,
+    RF_UI_CONTROL_HOME,
+    RF_UI_CONTROL_END,
+    RF_UI_CONTROL_SELECT_HOLD,
+    RF_UI_CONTROL_WORD_HOLD,
+    RF_UI_CONTROL_SELECT_ALL,
+    RF_UI_CONTROL_UNDO,
+    RF_UI_CONTROL_REDO,
     RF_MAX_UI_CONTROL
 };
 
+enum {
+    RF_UI_COMMAND_RECT,
+    RF_UI_COMMAND_LINE,
+    RF_UI_COMMAND_TEXT,
+    RF_MAX_UI_COMMAND
+};
+
+enum {
+    RF_UI_STYLE_CUSTOM,
+    RF_UI_STYLE_BUTTON,
+    RF_UI_STYLE_SLIDER_TRACK,
+    RF_UI_STYLE_SLIDER_FILL,
+    RF_UI_STYLE_LINE_EDIT,
+    RF_UI_STYLE_TEXT,
+    RF_UI_STYLE_LIST,
+    RF_UI_STYLE_SCROLLBAR_TRACK,
+    RF_UI_STYLE_SCROLLBAR_THUMB,
+    RF_UI_STYLE_TEXT_SELECTION,
+    RF_UI_STYLE_TEXT_CARET,
+    RF_UI_STYLE_TREE_NODE,
+    RF_UI_STYLE_WINDOW,
+    RF_UI_STYLE_WINDOW_TITLE,
+    RF_UI_STYLE_TAB,
+    RF_UI_STYLE_DOCK_PREVIEW,
+    RF_MAX_UI_STYLE
+};
+
+enum {
+    RF_UI_DRAW_HOT    = (1 << 0),
+    RF_UI_DRAW_ACTIVE = (1 << 1)
+};
+
+typedef struct rf_UICommand {
+    uint8_t type,
+            style;
+    uint16_t flags;
+    uint32_t color;
+    uint32_t clip;
+    uint32_t text_offset,
+             text_len;
+    rf_ui_id id;
+    float x, y, w, h;
+    float thickness;
+} rf_UICommand;
+
+typedef struct rf_UIVertex {
+    float x, y;
+    float u, v;
+    uint32_t color;
+} rf_UIVertex;
+
+typedef struct rf_UIRect {
+    float x, y, w, h;
+} rf_UIRect;
+
+typedef struct rf_UIDrawHashes {
+    uint64_t *hashes;
+    rf_UIRect *bounds;
+    uint64_t *table;
+    uint32_t count,
+             hash_cap,
+             bounds_cap,
+             table_cap;
+} rf_UIDrawHashes;
+
+typedef struct rf_UIDrawBatch {
+    float clip_x, clip_y, clip_w, clip_h;
+    uint32_t index_offset,
+             index_count;
+} rf_UIDrawBatch;
+
+typedef float (* rf_UIGlyphFunc)(void *user_data, uint32_t codepoint, float x, float y, float *quad, float *uv);
+
+typedef struct rf_UIDrawList {
+    uint32_t colors[RF_MAX_UI_STYLE][3];
+
+    rf_UICommand *commands;
+    uint32_t command_count,
+             command_cap;
+
+    char *text;
+    uint32_t text_size,
+             text_cap;
+
+    float *clips;
+    uint32_t clip_count,
+             clip_cap;
+
+    rf_UIVertex *vertices;
+    uint32_t vertex_count,
+             vertex_cap;
+
+    uint32_t *indices;
+    uint32_t index_count,
+             index_cap;
+
+    rf_UIDrawBatch *batches;
+    uint32_t batch_count,
+             batch_cap;
+
+    rf_UIDrawHashes frames[2];
+    uint32_t current_frame;
+    rf_UIRect damage[RF_UI_MAX_DAMAGE_RECTS];
+    uint32_t damage_count;
+} rf_UIDrawList;
+
+enum {
+    RF_UI_LAYOUT_ROW,
+    RF_UI_LAYOUT_COLUMN,
+    RF_UI_LAYOUT_GRID
+};
+
+enum {
+    RF_UI_SIZE_PIXELS,
+    RF_UI_SIZE_FRACTION,
+    RF_UI_SIZE_AUTO
+};
+
+#define rf_ui_rect_args(r) (r).x, (r).y, (r).w, (r).h
+
+typedef struct rf_UISize {
+    int kind;
+    float value;
+} rf_UISize;
+
+typedef struct rf_UILayout {
+    rf_ui_id id;
+    uint8_t direction;
+    float x, y, w, h;
+    float spacing;
+    float cursor;
+    float fixed_total,
+          fraction_total;
+    uint32_t child_count;
+    float cached_fixed_total,
+          cached_fraction_total;
+    uint32_t cached_child_count;
+    uint32_t columns;
+    float cell_h;
+} rf_UILayout;
+
+typedef struct rf_UIListView {
+    rf_ui_id id;
+    float x, y, w, h;
+    float row_h;
+    float scroll;
+    uint32_t row_count;
+    uint32_t first,
+             last;
+    uint32_t column_count;
+    const float *column_widths;
+} rf_UIListView;
+
+typedef struct rf_UIScrollView {
+    rf_ui_id id;
+    float x, y, w, h;
+    float scroll,
+          content_h;
+} rf_UIScrollView;
+
+typedef struct rf_UITreeLevel {
+    rf_ui_id id,
+             active;
+    unsigned int layout_depth;
+    float cursor,
+          fixed_total;
+    uint32_t child_count;
+} rf_UITreeLevel;
+
+typedef struct rf_UIWindow {
+    rf_ui_id id;
+    float x, y, w, h;
+    rf_ui_id dock;
+    int floating;
+    uint32_t record;
+} rf_UIWindow;
+
+typedef struct rf_UIWindowRecord {
+    rf_ui_id id;
+    int32_t z,
+            rank;
+    rf_UIRect rect;
+    uint32_t command_start,
+             command_end;
+} rf_UIWindowRecord;
+
+typedef struct rf_UIDock {
+    rf_ui_id id;
+    float x, y, w, h;
+    float tab_cursor;
+    rf_ui_id selected,
+             next_selected,
+             first_tab;
+    int selected_seen;
+} rf_UIDock;
+
+typedef struct rf_UIArena {
+    uint8_t *memory;
+    size_t size,
+           used;
+} rf_UIArena;
+
+typedef struct rf_UIFocusItem {
+    rf_ui_id id;
+    float x, y, w, h;
+} rf_UIFocusItem;
+
+enum {
+    RF_UI_EVENT_CONTROL,
+    RF_UI_EVENT_TEXT,
+    RF_UI_EVENT_CURSOR,
+    RF_UI_EVENT_SCROLL
+};
+
+typedef struct rf_UIEvent {
+    uint8_t type;
+    uint8_t control;
+    uint8_t down;
+    uint8_t buttons;
+    uint8_t modifiers;
+    uint32_t codepoint;
+    float x, y;
+    float scroll;
+    uint32_t time;
+} rf_UIEvent;
+
+typedef struct rf_UIRecordedFrame {
+    float cursor_x, cursor_y,
+          input_x, input_y,
+          scroll_y,
+          delta_time;
+    char char_input;
+    uint32_t event_offset,
+             event_count;
+} rf_UIRecordedFrame;
+
+typedef struct rf_UIRecording {
+    rf_UIRecordedFrame *frames;
+    uint32_t frame_count,
+             frame_cap;
+    int32_t *controls;
+    uint8_t *held;
+    uint32_t control_cap,
+             held_cap;
+    rf_UIEvent *events;
+    uint32_t event_count,
+             event_cap;
+} rf_UIRecording;
+
+enum {
+    RF_UI_ROLE_BUTTON,
+    RF_UI_ROLE_SLIDER,
+    RF_UI_ROLE_DRAG,
+    RF_UI_ROLE_GROUP,
+    RF_UI_ROLE_LINE_EDIT,
+    RF_UI_ROLE_TEXT_BOX,
+    RF_UI_ROLE_LIST,
+    RF_UI_ROLE_SCROLL_REGION,
+    RF_UI_ROLE_TREE_NODE,
+    RF_UI_ROLE_TREE_LEAF,
+    RF_UI_ROLE_WINDOW,
+    RF_UI_ROLE_DOCK_SPACE,
+    RF_MAX_UI_ROLE
+};
+
+enum {
+    RF_UI_ACCESS_HOT      = (1 << 0),
+    RF_UI_ACCESS_ACTIVE   = (1 << 1),
+    RF_UI_ACCESS_HIDDEN   = (1 << 2),
+    RF_UI_ACCESS_EXPANDED = (1 << 3)
+};
+
+typedef struct rf_UIAccessNode {
+    rf_ui_id id;
+    uint8_t role,
+            flags;
+    uint32_t parent;
+    rf_UIRect rect;
+    float value;
+    uint32_t label_offset,
+             label_len,
+             text_offset,
+             text_len;
+} rf_UIAccessNode;
+
+typedef struct rf_UIAccessTree {
+    rf_UIAccessNode *nodes;
+    uint32_t node_count,
+             node_cap;
+
+    char *text;
+    uint32_t text_size,
+             text_cap;
+
+    uint32_t *id_index,
+             *label_index;
+    uint32_t index_cap;
+    int indexed;
+
+    uint32_t parents[RF_UI_ACCESS_STACK_SIZE];
+    uint32_t parent_count;
+} rf_UIAccessTree;
+
+enum {
+    RF_UI_TEXT_LEFT,
+    RF_UI_TEXT_RIGHT,
+    RF_UI_TEXT_WORD_LEFT,
+    RF_UI_TEXT_WORD_RIGHT,
+    RF_UI_TEXT_UP,
+    RF_UI_TEXT_DOWN,
+    RF_UI_TEXT_LINE_START,
+    RF_UI_TEXT_LINE_END,
+    RF_UI_TEXT_START,
+    RF_UI_TEXT_END
+};
+
+typedef struct rf_UITextEdit {
+    uint32_t pos, len;
+    uint32_t text_offset;
+    uint32_t cursor, anchor;
+    uint32_t group;
+    uint8_t insert;
+} rf_UITextEdit;
+
+typedef struct rf_UITextBuffer {
+    char *data;
+    uint32_t gap_start, gap_end,
+             cap;
+
+    uint32_t cursor, anchor;
+    uint32_t column;
+
+    uint32_t *line_starts;
+    uint32_t line_count,
+             line_cap;
+
+    rf_UITextEdit *edits;
+    uint32_t edit_count,
+             edit_pos,
+             edit_cap;
+    char *edit_text;
+    uint32_t edit_text_size,
+             edit_text_cap;
+    uint32_t group;
+    int typing;
+
+    uint32_t version;
+} rf_UITextBuffer;
+
+typedef float (* rf_UITextWidthFunc)(void *user_data, const char *text, uint32_t len);
+
+typedef struct rf_UIWidgetState {
+    rf_ui_id id;
+    uint32_t frame;
+    int32_t i[4];
+    float f[4];
+} rf_UIWidgetState;
+
 typedef struct rf_UIState {
     rf_ui_id hot,
              active;
 
-    rf_ui_id focus_ids[RF_UI_MAX_ELEMENTS];
-    unsigned int focus_id_count;
+    rf_ui_id id_stack[RF_UI_ID_STACK_SIZE];
+    unsigned int id_stack_size;
+
+    uint32_t frame;
+
+    rf_UIDrawList *draw_list;
+    rf_UIAccessTree *access_tree;
+    const char *access_label;
+    float clip_stack[RF_UI_CLIP_STACK_SIZE][4];
+    uint32_t clip_index_stack[RF_UI_CLIP_STACK_SIZE];
+    unsigned int clip_stack_size,
+                 clip_overflow;
+    uint32_t clip_index;
+
+    rf_UILayout layout_stack[RF_UI_LAYOUT_STACK_SIZE];
+    unsigned int layout_stack_size,
+                 layout_overflow;
+    float layout_padding,
+          layout_spacing;
+
+    int layer_stack[RF_UI_LAYER_STACK_SIZE];
+    unsigned int layer_stack_size;
+    int layer;
+    rf_ui_id hit_id,
+             hit_scroll_id,
+             scroll_hover;
+    int hit_layer,
+        hit_scroll_layer;
+
+    rf_UIWidgetState *states;
+    uint32_t state_count,
+             state_cap,
+             state_touched;
+
+    rf_UIFocusItem *focus_items;
+    uint32_t focus_item_count,
+             focus_item_cap;
+
+    uint32_t *nav_cells,
+             *nav_items;
+    uint32_t nav_cell_cap,
+             nav_item_cap,
+             nav_dim;
+    float nav_x, nav_y,
+          nav_cell_w, nav_cell_h;
     long int current_focus_id,
              current_focus_group;
     int focusing;
 
     float cursor_x, cursor_y;
+    float scroll_y;
     int controls[RF_MAX_UI_CONTROL];
     char char_input;
+
+    rf_UIEvent *events;
+    uint32_t event_count,
+             event_cap,
+             pointer_event_count,
+             key_event_count;
+    float input_x, input_y;
+    uint8_t control_held[RF_MAX_UI_CONTROL];
+
+    int idle,
+        frame_requested;
+    rf_ui_id idle_hash;
+
+    rf_UITextWidthFunc text_width_func;
+    void *text_width_user;
+    float line_height;
+    rf_UITextBuffer edit_buffer;
+    rf_ui_id edit_id;
+
+    struct rf_UIState **panels;
+    uint32_t panel_count,
+             panel_cap;
+    rf_ui_id panel_active;
+
+    float delta_time;
+    rf_ui_id *anim_ids;
+    uint32_t *anim_frames;
+    float *anim_starts,
+          *anim_targets,
+          *anim_values,
+          *anim_times,
+          *anim_rates;
+    uint32_t anim_count,
+             anim_cap,
+             anim_touched,
+             anim_moving;
+    uint32_t *anim_table;
+    uint32_t anim_table_cap;
+
+    rf_UITreeLevel tree_stack[RF_UI_TREE_STACK_SIZE];
+    unsigned int tree_depth;
+    rf_ui_id *tree_open;
+    uint32_t tree_open_count,
+             tree_open_cap;
+
+    rf_UIWindowRecord *windows;
+    uint32_t window_count,
+             window_cap;
+    unsigned int window_depth;
+    rf_UIDock *docks;
+    uint32_t dock_count,
+             dock_cap;
+    rf_UICommand *window_commands;
+    uint32_t window_command_cap;
+    rf_ui_id window_hit_id,
+             window_hover;
+    int window_hit_layer;
+    int32_t window_z;
+    float window_drag_x,
+          window_drag_y;
 } rf_UIState;
 
 rf_UIState rf_ui_init(void);
+rf_UIArena rf_ui_arena_init(void *memory, size_t size);
+rf_UIState *rf_ui_arena_push_state(rf_UIArena *arena);
 void rf_ui_begin(rf_UIState *ui);
 void rf_ui_end(rf_UIState *ui);
+void rf_ui_clean_up(rf_UIState *ui);
+rf_UIWidgetState *rf_ui_get_state(rf_UIState *ui, rf_ui_id id);
+rf_UIWidgetState *rf_ui_find_state(rf_UIState *ui, rf_ui_id id);
+float rf_ui_animate(rf_UIState *ui, rf_ui_id id, float target, float duration);
+rf_ui_id rf_ui_hash(const void *data, size_t size, rf_ui_id seed);
+rf_ui_id rf_ui_get_id(rf_UIState *ui, const char *label);
+rf_ui_id rf_ui_get_id_ptr(rf_UIState *ui, const void *ptr);
+rf_ui_id rf_ui_get_id_int(rf_UIState *ui, int64_t i);
+void rf_ui_push_id(rf_UIState *ui, rf_ui_id id);
+void rf_ui_pop_id(rf_UIState *ui);
+rf_UIDrawList rf_ui_draw_list_init(void);
+void rf_ui_draw_list_clean_up(rf_UIDrawList *list);
+void rf_ui_set_draw_list(rf_UIState *ui, rf_UIDrawList *list);
+rf_UIAccessTree rf_ui_access_tree_init(void);
+void rf_ui_access_tree_clean_up(rf_UIAccessTree *tree);
+void rf_ui_set_access_tree(rf_UIState *ui, rf_UIAccessTree *tree);
+void rf_ui_access_label(rf_UIState *ui, const char *label);
+const rf_UIAccessNode *rf_ui_access_find(const rf_UIAccessTree *tree, rf_ui_id id);
+const rf_UIAccessNode *rf_ui_access_find_label(const rf_UIAccessTree *tree, const char *label);
+void rf_ui_push_clip(rf_UIState *ui, float x, float y, float w, float h);
+void rf_ui_pop_clip(rf_UIState *ui);
+void rf_ui_draw_rect(rf_UIState *ui, float x, float y, float w, float h, uint32_t color);
+void rf_ui_draw_line(rf_UIState *ui, float x0, float y0, float x1, float y1, float thickness, uint32_t color);
+void rf_ui_draw_text(rf_UIState *ui, float x, float y, const char *text, uint32_t color);
+void rf_ui_build_vertices(rf_UIDrawList *list, float white_u, float white_v, rf_UIGlyphFunc glyph_func, void *user_data);
+rf_UIRect rf_ui_rect(float x, float y, float w, float h);
+rf_UISize rf_ui_pixels(float pixels);
+rf_UISize rf_ui_fraction(float fraction);
+rf_UISize rf_ui_auto(void);
+void rf_ui_layout_begin(rf_UIState *ui, rf_ui_id id, int direction, rf_UIRect rect);
+void rf_ui_layout_push(rf_UIState *ui, rf_ui_id id, int direction, rf_UISize size);
+void rf_ui_layout_grid(rf_UIState *ui, rf_ui_id id, unsigned int columns, float cell_h, rf_UISize size);
+void rf_ui_layout_pop(rf_UIState *ui);
+rf_UIRect rf_ui_layout_next(rf_UIState *ui, rf_UISize size);
+void rf_ui_push_layer(rf_UIState *ui, int layer);
+void rf_ui_pop_layer(rf_UIState *ui);
+int rf_ui_hit_rect(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h);
+void rf_ui_input_control(rf_UIState *ui, int control, int down, uint32_t time);
+void rf_ui_input_text(rf_UIState *ui, uint32_t codepoint, uint32_t time);
+void rf_ui_input_cursor(rf_UIState *ui, float x, float y, uint32_t time);
+void rf_ui_input_scroll(rf_UIState *ui, float scroll_y, uint32_t time);
+void rf_ui_request_frame(rf_UIState *ui);
+void rf_ui_panel_begin(rf_UIState *ui, rf_UIState *panel, rf_ui_id id);
+rf_UIRecording rf_ui_recording_init(void);
+void rf_ui_recording_clean_up(rf_UIRecording *rec);
+void rf_ui_record_frame(rf_UIState *ui, rf_UIRecording *rec);
+int rf_ui_replay_frame(rf_UIState *ui, const rf_UIRecording *rec, uint32_t frame);
+uint32_t rf_ui_recording_save(const rf_UIRecording *rec, void **data);
+int rf_ui_recording_load(rf_UIRecording *rec, const void *data, uint32_t size);
 int rf_button(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h);
 float rf_slider(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float value);
+float rf_slider_range(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float value,
+                      float min, float max, int decimals);
+float rf_drag_float(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float value,
+                    float speed, float min, float max, int decimals);
+int rf_drag_int(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, int value,
+                float speed, int min, int max);
+int rf_drag_float_n(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float *values, uint32_t count,
+                    float speed, float min, float max, int decimals);
+uint32_t rf_ui_format_int(char *out, int64_t value);
+uint32_t rf_ui_format_float(char *out, double value, int decimals);
 char *rf_line_edit(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, char *text, unsigned int max_chars);
+int rf_text_box(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, rf_UITextBuffer *buf);
+rf_UITextBuffer rf_ui_text_init(void);
+void rf_ui_text_clean_up(rf_UITextBuffer *buf);
+void rf_ui_text_set(rf_UITextBuffer *buf, const char *text, uint32_t len);
+uint32_t rf_ui_text_length(const rf_UITextBuffer *buf);
+char rf_ui_text_at(const rf_UITextBuffer *buf, uint32_t pos);
+uint32_t rf_ui_text_copy(const rf_UITextBuffer *buf, uint32_t start, uint32_t end, char *out);
+const char *rf_ui_text_span(rf_UITextBuffer *buf, uint32_t start, uint32_t end);
+void rf_ui_text_insert(rf_UITextBuffer *buf, const char *text, uint32_t len);
+void rf_ui_text_delete(rf_UITextBuffer *buf, int motion);
+void rf_ui_text_move(rf_UITextBuffer *buf, int motion, int select);
+void rf_ui_text_select(rf_UITextBuffer *buf, uint32_t anchor, uint32_t cursor);
+void rf_ui_text_undo(rf_UITextBuffer *buf);
+void rf_ui_text_redo(rf_UITextBuffer *buf);
+uint32_t rf_ui_text_line_count(const rf_UITextBuffer *buf);
+uint32_t rf_ui_text_line_of(const rf_UITextBuffer *buf, uint32_t pos);
+uint32_t rf_ui_text_line_start(const rf_UITextBuffer *buf, uint32_t line);
+uint32_t rf_ui_text_line_end(const rf_UITextBuffer *buf, uint32_t line);
+int rf_ui_list_begin(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, uint32_t row_count, float row_h, rf_UIListView *view);
+rf_UIRect rf_ui_list_row(rf_UIState *ui, rf_UIListView *view, uint32_t row);
+void rf_ui_list_end(rf_UIState *ui, rf_UIListView *view);
+int rf_ui_table_begin(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, uint32_t row_count, float row_h,
+                      uint32_t column_count, const float *column_widths, rf_UIListView *view);
+rf_UIRect rf_ui_table_cell(rf_UIState *ui, rf_UIListView *view, uint32_t row, uint32_t column);
+void rf_ui_table_end(rf_UIState *ui, rf_UIListView *view);
+void rf_ui_scroll_begin(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float content_h, rf_UIScrollView *view);
+void rf_ui_scroll_end(rf_UIState *ui, rf_UIScrollView *view);
+int rf_ui_tree_push(rf_UIState *ui, rf_ui_id id, const char *label);
+void rf_ui_tree_pop(rf_UIState *ui);
+int rf_ui_tree_leaf(rf_UIState *ui, rf_ui_id id, const char *label);
+int rf_ui_tree_is_open(rf_UIState *ui, rf_ui_id id);
+void rf_ui_tree_set_open(rf_UIState *ui, rf_ui_id id, int open);
+void rf_ui_dock_space(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h);
+int rf_ui_window_begin(rf_UIState *ui, rf_ui_id id, const char *title, float x, float y, float w, float h,
+                       int *open, rf_UIWindow *window);
+void rf_ui_window_end(rf_UIState *ui, rf_UIWindow *window);
 
 #ifdef RF_UI_IMPLEMENTATION
 
@@ -407,220 +1836,4160 @@ unsigned int _rf__ui_strlen(char *s) {
     return len;
 }
 
-rf_UIState rf_ui_init(void) {
-    rf_UIState ui;
-    ui.hot = -1;
-    ui.active = -1;
+rf_ui_id rf_ui_hash(const void *data, size_t size, rf_ui_id seed) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    rf_ui_id hash = seed ^ 14695981039346656037ULL;
+    for(size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash ? hash : 1;
+}
 
-    ui.focus_id_count = 0;
-    ui.current_focus_id = -1;
-    ui.current_focus_group = 0;
-    ui.focusing = 0;
+rf_ui_id _rf__ui_id_seed(rf_UIState *ui) {
+    return ui->id_stack_size ? ui->id_stack[ui->id_stack_size-1] : 0;
+}
 
-    ui.cursor_x = 0;
-    ui.cursor_y = 0;
-    for(int i = 0; i < RF_MAX_UI_CONTROL; ++i) {
-        ui.controls[i] = 0;
+rf_ui_id rf_ui_get_id(rf_UIState *ui, const char *label) {
+    return rf_ui_hash(label, _rf__ui_strlen((char *)label), _rf__ui_id_seed(ui));
+}
+
+rf_ui_id rf_ui_get_id_ptr(rf_UIState *ui, const void *ptr) {
+    return rf_ui_hash(&ptr, sizeof(ptr), _rf__ui_id_seed(ui));
+}
+
+rf_ui_id rf_ui_get_id_int(rf_UIState *ui, int64_t i) {
+    return rf_ui_hash(&i, sizeof(i), _rf__ui_id_seed(ui));
+}
+
+void rf_ui_push_id(rf_UIState *ui, rf_ui_id id) {
+    if(ui->id_stack_size < RF_UI_ID_STACK_SIZE) {
+        ui->id_stack[ui->id_stack_size++] = id;
     }
-    ui.char_input = 0;
-    return ui;
 }
 
-void rf_ui_begin(rf_UIState *ui) {
-    ui->cursor_x = 0;
-    ui->cursor_y = 0;
-    for(int i = 0; i < RF_MAX_UI_CONTROL; ++i) {
-        ui->controls[i] = 0;
+void rf_ui_pop_id(rf_UIState *ui) {
+    if(ui->id_stack_size) {
+        --ui->id_stack_size;
     }
-    ui->focus_id_count = 0;
 }
 
-void rf_ui_end(rf_UIState *ui) {
-    if(ui->current_focus_id < 0) {
-        if(ui->focus_id_count &&
-           (ui->controls[RF_UI_CONTROL_UP_PRESS] ||
-            ui->controls[RF_UI_CONTROL_LEFT_PRESS] ||
-            ui->controls[RF_UI_CONTROL_DOWN_PRESS] ||
-            ui->controls[RF_UI_CONTROL_RIGHT_PRESS])) {
-            ui->current_focus_id = 0;
+void _rf__ui_delete_state(rf_UIState *ui, uint32_t slot) {
+    uint32_t mask = ui->state_cap - 1;
+    uint32_t hole = slot;
+    for(uint32_t i = (slot + 1) & mask; ui->states[i].id; i = (i + 1) & mask) {
+        uint32_t home = (uint32_t)ui->states[i].id & mask;
+        if(((i - home) & mask) >= ((i - hole) & mask)) {
+            ui->states[hole] = ui->states[i];
+            hole = i;
         }
     }
-    else {
-        if(ui->focus_id_count) {
-            int focus_update = 0;
-            if(ui->controls[RF_UI_CONTROL_DOWN_PRESS]) {
-                if(++ui->current_focus_id >= ui->focus_id_count) {
-                    ui->current_focus_id = 0;
-                }
-                focus_update = 1;
-            }
-            if(ui->controls[RF_UI_CONTROL_UP_PRESS]) {
-                if(--ui->current_focus_id < 0) {
-                    ui->current_focus_id = ui->focus_id_count-1;
-                }
-                focus_update = 1;
-            }
+    ui->states[hole].id = 0;
+    --ui->state_count;
+}
 
-            if(focus_update) {
-                if(ui->current_focus_id < 0 || ui->current_focus_id >= ui->focus_id_count) {
-                    ui->current_focus_id = 0;
-                }
-                ui->hot = ui->focus_ids[ui->current_focus_id];
-            }
+void _rf__ui_collect_states(rf_UIState *ui) {
+    // nothing to do if every state was requested this frame
+    if(ui->state_touched == ui->state_count) {
+        return;
+    }
+    for(uint32_t i = 0; i < ui->state_cap && ui->state_count;) {
+        if(ui->states[i].id && ui->states[i].frame != ui->frame) {
+            _rf__ui_delete_state(ui, i);
         }
         else {
-            ui->current_focus_id = -1;
+            ++i;
         }
     }
 }
 
-void rf_ui_focus(rf_UIState *ui, long int group) {
-    ui->focusing = (ui->current_focus_group == group || !group);
-}
+void _rf__ui_build_animation_table(rf_UIState *ui, uint32_t table_cap) {
+    if(ui->anim_table_cap != table_cap) {
+        ui->anim_table = (uint32_t *)RF_UI_REALLOC(ui->anim_table, table_cap * sizeof(uint32_t));
+        ui->anim_table_cap = table_cap;
+    }
+    for(uint32_t i = 0; i < table_cap; ++i) {
+        ui->anim_table[i] = 0;
+    }
 
-void rf_ui_unfocus(rf_UIState *ui) {
-    ui->focusing = 0;
+    // slots hold index + 1, so 0 is empty
+    uint32_t mask = table_cap - 1;
+    for(uint32_t i = 0; i < ui->anim_count; ++i) {
+        uint32_t slot = (uint32_t)ui->anim_ids[i] & mask;
+        while(ui->anim_table[slot]) {
+            slot = (slot + 1) & mask;
+        }
+        ui->anim_table[slot] = i + 1;
+    }
 }
 
-int rf_button(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h) {
-    int activated = 0;
-
-    if(ui->focusing && ui->focus_id_count < RF_UI_MAX_ELEMENTS) {
-        ui->focus_ids[ui->focus_id_count++] = id;
+float rf_ui_animate(rf_UIState *ui, rf_ui_id id, float target, float duration) {
+    uint32_t mask = ui->anim_table_cap - 1,
+             slot = (uint32_t)id & mask,
+             index = ui->anim_count;
+    if(ui->anim_table_cap) {
+        for(; ui->anim_table[slot]; slot = (slot + 1) & mask) {
+            if(ui->anim_ids[ui->anim_table[slot] - 1] == id) {
+                index = ui->anim_table[slot] - 1;
+                break;
+            }
+        }
     }
 
-    if(ui->current_focus_id < 0) {
-        if(_rf__ui_cursor_over(ui, x, y, w, h)) {
-            if(ui->hot < 0) {
-                ui->hot = id;
-            }
-            if(_rf__ui_id_equ(ui->active, id) && !ui->controls[RF_UI_CONTROL_LEFT_MOUSE]) {
-                activated = 1;
-            }
+    if(index == ui->anim_count) {
+        if(ui->anim_count >= ui->anim_cap) {
+            uint32_t cap = ui->anim_cap ? ui->anim_cap * 2 : _RF_UI_ARRAY_START_CAP;
+            ui->anim_ids = (rf_ui_id *)RF_UI_REALLOC(ui->anim_ids, cap * sizeof(rf_ui_id));
+            ui->anim_frames = (uint32_t *)RF_UI_REALLOC(ui->anim_frames, cap * sizeof(uint32_t));
+            ui->anim_starts = (float *)RF_UI_REALLOC(ui->anim_starts, cap * sizeof(float));
+            ui->anim_targets = (float *)RF_UI_REALLOC(ui->anim_targets, cap * sizeof(float));
+            ui->anim_values = (float *)RF_UI_REALLOC(ui->anim_values, cap * sizeof(float));
+            ui->anim_times = (float *)RF_UI_REALLOC(ui->anim_times, cap * sizeof(float));
+            ui->anim_rates = (float *)RF_UI_REALLOC(ui->anim_rates, cap * sizeof(float));
+            ui->anim_cap = cap;
+        }
+        ui->anim_ids[index] = id;
+        ui->anim_starts[index] = target;
+        ui->anim_targets[index] = target;
+        ui->anim_values[index] = target;
+        ui->anim_times[index] = 1;
+        ui->anim_frames[index] = ui->frame - 1;
+        ++ui->anim_count;
+
+        if(ui->anim_count * 2 > ui->anim_table_cap) {
+            _rf__ui_build_animation_table(ui, ui->anim_table_cap ? ui->anim_table_cap * 2 : _RF_UI_ARRAY_START_CAP);
         }
         else {
-            if(_rf__ui_id_equ(ui->hot, id)) {
-                ui->hot = -1;
-            }
+            ui->anim_table[slot] = index + 1;
         }
+    }
 
-        if(_rf__ui_id_equ(ui->hot, id)) {
-            if(ui->controls[RF_UI_CONTROL_LEFT_MOUSE]) {
-                ui->active = id;
-            }
-        }
+    ui->anim_touched += ui->anim_frames[index] != ui->frame;
+    ui->anim_frames[index] = ui->frame;
+    ui->anim_rates[index] = duration > 0 ? 1.f / duration : 1e30f;
+    if(ui->anim_targets[index] != target) {
+        ui->anim_starts[index] = ui->anim_values[index];
+        ui->anim_targets[index] = target;
+        ui->anim_times[index] = 0;
+        ++ui->anim_moving;
     }
-    else {
-        if(_rf__ui_id_equ(ui->hot, id)) {
-            if(ui->controls[RF_UI_CONTROL_ACTIVATE]) {
-                activated = 1;
+    return ui->anim_values[index];
+}
+
+// drops animations that weren't requested this frame, then advances all of
+// the others in one branch-free pass over the arrays
+void _rf__ui_update_animations(rf_UIState *ui) {
+    // with nothing dropped and nothing moving, there's nothing to do
+    if(ui->anim_touched == ui->anim_count && !ui->anim_moving) {
+        return;
+    }
+
+    if(ui->anim_touched != ui->anim_count) {
+        uint32_t count = 0;
+        for(uint32_t i = 0; i < ui->anim_count; ++i) {
+            if(ui->anim_frames[i] == ui->frame) {
+                ui->anim_ids[count] = ui->anim_ids[i];
+                ui->anim_frames[count] = ui->anim_frames[i];
+                ui->anim_starts[count] = ui->anim_starts[i];
+                ui->anim_targets[count] = ui->anim_targets[i];
+                ui->anim_values[count] = ui->anim_values[i];
+                ui->anim_times[count] = ui->anim_times[i];
+                ui->anim_rates[count] = ui->anim_rates[i];
+                ++count;
             }
         }
+        ui->anim_count = count;
+        _rf__ui_build_animation_table(ui, ui->anim_table_cap);
     }
 
-    return activated;
+    uint32_t count = ui->anim_count;
+    float dt = ui->delta_time;
+    const float *starts = ui->anim_starts,
+                *targets = ui->anim_targets,
+                *rates = ui->anim_rates;
+    float *values = ui->anim_values,
+          *times = ui->anim_times;
+    uint32_t moving = 0,
+             still_moving = 0;
+    for(uint32_t i = 0; i < count; ++i) {
+        // counted before stepping, so the frame that shows the final value
+        // is still requested
+        moving += times[i] < 1.f;
+        float t = times[i] + dt * rates[i];
+        t = t < 1.f ? t : 1.f;
+        float u = 1.f - t;
+        values[i] = starts[i] + (targets[i] - starts[i]) * (1.f - u*u*u);
+        times[i] = t;
+        still_moving += t < 1.f;
+    }
+    ui->anim_moving = still_moving;
+    if(moving) {
+        rf_ui_request_frame(ui);
+    }
 }
 
-float rf_slider(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float value) {
-    if(ui->focusing && ui->focus_id_count < RF_UI_MAX_ELEMENTS) {
-        ui->focus_ids[ui->focus_id_count++] = id;
-    }
+void _rf__ui_grow_states(rf_UIState *ui) {
+    rf_UIWidgetState *old_states = ui->states;
+    uint32_t old_cap = ui->state_cap;
 
-    if(ui->current_focus_id < 0) {
-        if(_rf__ui_id_equ(ui->active, id)) {
-            if(ui->controls[RF_UI_CONTROL_LEFT_MOUSE]) {
-                value = (ui->cursor_x - x)/w;
-            }
-            else {
-                ui->active = -1;
-            }
-        }
-        else {
-            if(_rf__ui_cursor_over(ui, x, y, w, h)) {
-                if(ui->hot < 0) {
-                    ui->hot = id;
-                }
-            }
-            else {
-                if(_rf__ui_id_equ(ui->hot, id)) {
-                    ui->hot = -1;
-                }
-            }
+    ui->state_cap = old_cap ? old_cap * 2 : _RF_UI_STATE_START_CAP;
+    ui->states = (rf_UIWidgetState *)RF_UI_REALLOC(NULL, ui->state_cap * sizeof(rf_UIWidgetState));
+    for(uint32_t i = 0; i < ui->state_cap; ++i) {
+        ui->states[i].id = 0;
+    }
 
-            if(_rf__ui_id_equ(ui->hot, id)) {
-                if(ui->controls[RF_UI_CONTROL_LEFT_MOUSE]) {
-                    ui->active = id;
-                }
+    uint32_t mask = ui->state_cap - 1;
+    for(uint32_t i = 0; i < old_cap; ++i) {
+        if(old_states[i].id) {
+            uint32_t slot = (uint32_t)old_states[i].id & mask;
+            while(ui->states[slot].id) {
+                slot = (slot + 1) & mask;
             }
+            ui->states[slot] = old_states[i];
         }
     }
-    else {
-        if(_rf__ui_id_equ(ui->hot, id)) {
-            ui->active = id;
-            if(ui->controls[RF_UI_CONTROL_RIGHT_HOLD]) {
-                if((value += 0.05) > 1) {
-                    value = 1;
-                }
-            }
-            if(ui->controls[RF_UI_CONTROL_LEFT_HOLD]) {
-                if((value -= 0.05) < 0) {
-                    value = 0;
-                }
+    RF_UI_FREE(old_states);
+}
+
+rf_UIWidgetState *rf_ui_find_state(rf_UIState *ui, rf_ui_id id) {
+    if(ui->state_cap) {
+        uint32_t mask = ui->state_cap - 1;
+        for(uint32_t i = (uint32_t)id & mask; ui->states[i].id; i = (i + 1) & mask) {
+            if(ui->states[i].id == id) {
+                return ui->states + i;
             }
         }
     }
+    return NULL;
+}
 
-    if(value < 0) {
-        value = 0;
+rf_UIWidgetState *rf_ui_get_state(rf_UIState *ui, rf_ui_id id) {
+    if((ui->state_count + 1) * 4 > ui->state_cap * 3) {
+        _rf__ui_grow_states(ui);
     }
-    else if(value > 1.f) {
-        value = 1.f;
+
+    uint32_t mask = ui->state_cap - 1;
+    uint32_t i = (uint32_t)id & mask;
+    for(; ui->states[i].id; i = (i + 1) & mask) {
+        if(ui->states[i].id == id) {
+            ui->state_touched += ui->states[i].frame != ui->frame;
+            ui->states[i].frame = ui->frame;
+            return ui->states + i;
+        }
     }
 
-    return value;
+    rf_UIWidgetState *state = ui->states + i;
+    state->id = id;
+    state->frame = ui->frame;
+    ++ui->state_touched;
+    for(int j = 0; j < 4; ++j) {
+        state->i[j] = 0;
+        state->f[j] = 0;
+    }
+    ++ui->state_count;
+    return state;
 }
 
-char *rf_line_edit(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, char *text, unsigned int max_chars) {
-    unsigned int text_len = _rf__ui_strlen(text);
-
-    if(ui->focusing && ui->focus_id_count < RF_UI_MAX_ELEMENTS) {
-        ui->focus_ids[ui->focus_id_count++] = id;
+void *_rf__ui_grow(void *data, uint32_t *cap, uint32_t element_size, uint32_t required) {
+    if(*cap < required) {
+        uint32_t new_cap = *cap ? *cap : _RF_UI_ARRAY_START_CAP;
+        while(new_cap < required) {
+            new_cap *= 2;
+        }
+        data = RF_UI_REALLOC(data, (size_t)new_cap * element_size);
+        *cap = new_cap;
     }
+    return data;
+}
 
-    if(ui->current_focus_id < 0) {
-        if(_rf__ui_cursor_over(ui, x, y, w, h)) {
-            if(ui->hot < 0) {
-                ui->hot = id;
+float _rf__ui_sqrt(float x) {
+    if(x <= 0) {
+        return 0;
+    }
+    float r = x > 1 ? x : 1;
+    for(int i = 0; i < 32; ++i) {
+        r = 0.5f * (r + x / r);
+    }
+    return r;
+}
+
+uint32_t _rf__ui_utf8_encode(uint32_t codepoint, char *out) {
+    if(codepoint < 0x80) {
+        out[0] = (char)codepoint;
+        return codepoint ? 1 : 0;
+    }
+    if(codepoint < 0x800) {
+        out[0] = (char)(0xC0 | codepoint >> 6);
+        out[1] = (char)(0x80 | (codepoint & 0x3F));
+        return 2;
+    }
+    if(codepoint < 0x10000) {
+        out[0] = (char)(0xE0 | codepoint >> 12);
+        out[1] = (char)(0x80 | (codepoint >> 6 & 0x3F));
+        out[2] = (char)(0x80 | (codepoint & 0x3F));
+        return 3;
+    }
+    if(codepoint < 0x110000) {
+        out[0] = (char)(0xF0 | codepoint >> 18);
+        out[1] = (char)(0x80 | (codepoint >> 12 & 0x3F));
+        out[2] = (char)(0x80 | (codepoint >> 6 & 0x3F));
+        out[3] = (char)(0x80 | (codepoint & 0x3F));
+        return 4;
+    }
+    return 0;
+}
+
+// len is how many bytes are left, so a sequence cut off at the end of a run
+// decodes as U+FFFD instead of reading past it
+uint32_t _rf__ui_utf8_decode(const char *text, uint32_t len, uint32_t *codepoint) {
+    const unsigned char *s = (const unsigned char *)text;
+    if(s[0] < 0x80) {
+        *codepoint = s[0];
+        return 1;
+    }
+    if(len >= 2 && (s[0] & 0xe0) == 0xc0 && (s[1] & 0xc0) == 0x80) {
+        *codepoint = ((s[0] & 0x1f) << 6) | (s[1] & 0x3f);
+        return 2;
+    }
+    if(len >= 3 && (s[0] & 0xf0) == 0xe0 && (s[1] & 0xc0) == 0x80 && (s[2] & 0xc0) == 0x80) {
+        *codepoint = ((s[0] & 0x0f) << 12) | ((s[1] & 0x3f) << 6) | (s[2] & 0x3f);
+        return 3;
+    }
+    if(len >= 4 && (s[0] & 0xf8) == 0xf0 && (s[1] & 0xc0) == 0x80 && (s[2] & 0xc0) == 0x80 && (s[3] & 0xc0) == 0x80) {
+        *codepoint = ((s[0] & 0x07) << 18) | ((s[1] & 0x3f) << 12) | ((s[2] & 0x3f) << 6) | (s[3] & 0x3f);
+        return 4;
+    }
+    *codepoint = 0xfffd;
+    return 1;
+}
+
+rf_UIDrawList rf_ui_draw_list_init(void) {
+    rf_UIDrawList list;
+
+    static const uint32_t default_colors[RF_MAX_UI_STYLE][3] = {
+        { 0xffffffff, 0xffffffff, 0xffffffff },
+        { 0x404040ff, 0x505050ff, 0x303030ff },
+        { 0x303030ff, 0x383838ff, 0x383838ff },
+        { 0x4060a0ff, 0x5070b0ff, 0x6080c0ff },
+        { 0x202020ff, 0x282828ff, 0x101010ff },
+        { 0xe0e0e0ff, 0xffffffff, 0xffffffff },
+        { 0x181818ff, 0x181818ff, 0x181818ff },
+        { 0x202020ff, 0x202020ff, 0x202020ff },
+        { 0x505050ff, 0x606060ff, 0x707070ff },
+        { 0x3050a0ff, 0x3050a0ff, 0x3050a0ff },
+        { 0xe0e0e0ff, 0xe0e0e0ff, 0xe0e0e0ff },
+        { 0x00000000, 0x383838ff, 0x303030ff },
+        { 0x282828ff, 0x282828ff, 0x282828ff },
+        { 0x304070ff, 0x384880ff, 0x405090ff },
+        { 0x202020ff, 0x303030ff, 0x303030ff },
+        { 0x4060a060, 0x4060a060, 0x4060a060 },
+    };
+    for(int i = 0; i < RF_MAX_UI_STYLE; ++i) {
+        for(int j = 0; j < 3; ++j) {
+            list.colors[i][j] = default_colors[i][j];
+        }
+    }
+
+    list.commands = NULL;
+    list.command_count = list.command_cap = 0;
+    list.text = NULL;
+    list.text_size = list.text_cap = 0;
+    list.clips = NULL;
+    list.clip_count = list.clip_cap = 0;
+    list.vertices = NULL;
+    list.vertex_count = list.vertex_cap = 0;
+    list.indices = NULL;
+    list.index_count = list.index_cap = 0;
+    list.batches = NULL;
+    list.batch_count = list.batch_cap = 0;
+    for(int i = 0; i < 2; ++i) {
+        list.frames[i].hashes = NULL;
+        list.frames[i].bounds = NULL;
+        list.frames[i].table = NULL;
+        list.frames[i].count = 0;
+        list.frames[i].hash_cap = list.frames[i].bounds_cap = list.frames[i].table_cap = 0;
+    }
+    list.current_frame = 0;
+    list.damage_count = 0;
+    return list;
+}
+
+void rf_ui_draw_list_clean_up(rf_UIDrawList *list) {
+    RF_UI_FREE(list->commands);
+    RF_UI_FREE(list->text);
+    RF_UI_FREE(list->clips);
+    RF_UI_FREE(list->vertices);
+    RF_UI_FREE(list->indices);
+    RF_UI_FREE(list->batches);
+    for(int i = 0; i < 2; ++i) {
+        RF_UI_FREE(list->frames[i].hashes);
+        RF_UI_FREE(list->frames[i].bounds);
+        RF_UI_FREE(list->frames[i].table);
+    }
+    *list = rf_ui_draw_list_init();
+}
+
+uint32_t _rf__ui_add_clip(rf_UIDrawList *list, float x, float y, float w, float h) {
+    list->clips = (float *)_rf__ui_grow(list->clips, &list->clip_cap, 4 * sizeof(float), list->clip_count + 1);
+    float *clip = list->clips + 4 * list->clip_count;
+    clip[0] = x;
+    clip[1] = y;
+    clip[2] = w;
+    clip[3] = h;
+    return list->clip_count++;
+}
+
+void _rf__ui_draw_list_reset(rf_UIDrawList *list) {
+    list->command_count = 0;
+    list->text_size = 0;
+    list->clip_count = 0;
+    _rf__ui_add_clip(list, -1e9f, -1e9f, 2e9f, 2e9f);
+}
+
+void rf_ui_set_draw_list(rf_UIState *ui, rf_UIDrawList *list) {
+    ui->draw_list = list;
+    if(list) {
+        _rf__ui_draw_list_reset(list);
+    }
+    ui->clip_index = 0;
+}
+
+void rf_ui_push_clip(rf_UIState *ui, float x, float y, float w, float h) {
+    if(ui->clip_stack_size) {
+        float *parent = ui->clip_stack[ui->clip_stack_size-1];
+        float x1 = x + w < parent[0] + parent[2] ? x + w : parent[0] + parent[2],
+              y1 = y + h < parent[1] + parent[3] ? y + h : parent[1] + parent[3];
+        x = x > parent[0] ? x : parent[0];
+        y = y > parent[1] ? y : parent[1];
+        w = x1 > x ? x1 - x : 0;
+        h = y1 > y ? y1 - y : 0;
+    }
+
+    if(ui->clip_stack_size < RF_UI_CLIP_STACK_SIZE) {
+        float *clip = ui->clip_stack[ui->clip_stack_size];
+        clip[0] = x;
+        clip[1] = y;
+        clip[2] = w;
+        clip[3] = h;
+        ui->clip_index_stack[ui->clip_stack_size++] = ui->clip_index;
+        if(ui->draw_list) {
+            ui->clip_index = _rf__ui_add_clip(ui->draw_list, x, y, w, h);
+        }
+    }
+    else {
+        ++ui->clip_overflow;
+    }
+}
+
+void rf_ui_pop_clip(rf_UIState *ui) {
+    if(ui->clip_overflow) {
+        --ui->clip_overflow;
+    }
+    else if(ui->clip_stack_size) {
+        ui->clip_index = ui->clip_index_stack[--ui->clip_stack_size];
+    }
+}
+
+rf_UICommand *_rf__ui_push_command(rf_UIState *ui, uint8_t type, uint8_t style, uint16_t flags, uint32_t color) {
+    rf_UIDrawList *list = ui->draw_list;
+    list->commands = (rf_UICommand *)_rf__ui_grow(list->commands, &list->command_cap, sizeof(rf_UICommand), list->command_count + 1);
+
+    rf_UICommand *command = list->commands + list->command_count++;
+    command->type = type;
+    command->style = style;
+    command->flags = flags;
+    command->color = color;
+    command->clip = ui->clip_index;
+    command->text_offset = 0;
+    command->text_len = 0;
+    command->id = 0;
+    command->thickness = 0;
+    return command;
+}
+
+uint32_t _rf__ui_style_color(rf_UIDrawList *list, uint8_t style, uint16_t flags) {
+    return list->colors[style][flags & RF_UI_DRAW_ACTIVE ? 2 : flags & RF_UI_DRAW_HOT ? 1 : 0];
+}
+
+rf_UIAccessTree rf_ui_access_tree_init(void) {
+    rf_UIAccessTree tree;
+    tree.nodes = NULL;
+    tree.node_count = tree.node_cap = 0;
+    tree.text = NULL;
+    tree.text_size = tree.text_cap = 0;
+    tree.id_index = NULL;
+    tree.label_index = NULL;
+    tree.index_cap = 0;
+    tree.indexed = 0;
+    tree.parent_count = 0;
+    return tree;
+}
+
+void rf_ui_access_tree_clean_up(rf_UIAccessTree *tree) {
+    RF_UI_FREE(tree->nodes);
+    RF_UI_FREE(tree->text);
+    RF_UI_FREE(tree->id_index);
+    RF_UI_FREE(tree->label_index);
+    *tree = rf_ui_access_tree_init();
+}
+
+void _rf__ui_access_tree_reset(rf_UIAccessTree *tree) {
+    tree->node_count = 0;
+    tree->text_size = 0;
+    tree->indexed = 0;
+    tree->parent_count = 0;
+}
+
+void rf_ui_set_access_tree(rf_UIState *ui, rf_UIAccessTree *tree) {
+    ui->access_tree = tree;
+    if(tree) {
+        _rf__ui_access_tree_reset(tree);
+    }
+    ui->access_label = NULL;
+}
+
+void rf_ui_access_label(rf_UIState *ui, const char *label) {
+    ui->access_label = label;
+}
+
+uint32_t _rf__ui_access_copy(rf_UIAccessTree *tree, const char *text, uint32_t len) {
+    uint32_t offset = tree->text_size;
+    tree->text = (char *)_rf__ui_grow(tree->text, &tree->text_cap, 1, offset + len + 1);
+    for(uint32_t i = 0; i < len; ++i) {
+        tree->text[offset + i] = text[i];
+    }
+    tree->text[offset + len] = 0;
+    tree->text_size += len + 1;
+    return offset;
+}
+
+// adds a widget's node under the innermost open container, labelled with
+// rf_ui_access_label's label if one is pending; returns its index + 1, or 0
+// when there's no tree (every other _rf__ui_access_ function ignores 0)
+uint32_t _rf__ui_access(rf_UIState *ui, rf_ui_id id, uint8_t role, float x, float y, float w, float h, const char *label) {
+    rf_UIAccessTree *tree = ui->access_tree;
+    if(!tree) {
+        return 0;
+    }
+    if(ui->access_label) {
+        label = ui->access_label;
+        ui->access_label = NULL;
+    }
+
+    int hidden = 0;
+    if(ui->clip_stack_size) {
+        float *clip = ui->clip_stack[ui->clip_stack_size-1];
+        hidden = x > clip[0] + clip[2] || x + w < clip[0] || y > clip[1] + clip[3] || y + h < clip[1];
+    }
+    uint32_t depth = tree->parent_count < RF_UI_ACCESS_STACK_SIZE ? tree->parent_count : RF_UI_ACCESS_STACK_SIZE;
+
+    tree->nodes = (rf_UIAccessNode *)_rf__ui_grow(tree->nodes, &tree->node_cap, sizeof(rf_UIAccessNode), tree->node_count + 1);
+    rf_UIAccessNode *node = tree->nodes + tree->node_count++;
+    node->id = id;
+    node->role = role;
+    node->flags = (ui->hot == id ? RF_UI_ACCESS_HOT : 0) |
+                  (ui->active == id ? RF_UI_ACCESS_ACTIVE : 0) |
+                  (hidden ? RF_UI_ACCESS_HIDDEN : 0);
+    node->parent = depth ? tree->parents[depth-1] : 0;
+    node->rect = rf_ui_rect(x, y, w, h);
+    node->value = 0;
+    node->label_len = label ? _rf__ui_strlen((char *)label) : 0;
+    node->label_offset = _rf__ui_access_copy(tree, label, node->label_len);
+    node->text_offset = node->label_offset + node->label_len;
+    node->text_len = 0;
+    return tree->node_count;
+}
+
+void _rf__ui_access_value(rf_UIState *ui, uint32_t node, float value) {
+    if(node) {
+        ui->access_tree->nodes[node-1].value = value;
+    }
+}
+
+void _rf__ui_access_flags(rf_UIState *ui, uint32_t node, uint8_t flags) {
+    if(node) {
+        ui->access_tree->nodes[node-1].flags |= flags;
+    }
+}
+
+void _rf__ui_access_text(rf_UIState *ui, uint32_t node, const char *text) {
+    if(node) {
+        uint32_t len = _rf__ui_strlen((char *)text),
+                 offset = _rf__ui_access_copy(ui->access_tree, text, len);
+        ui->access_tree->nodes[node-1].text_offset = offset;
+        ui->access_tree->nodes[node-1].text_len = len;
+    }
+}
+
+// widgets built until the matching pop are children of node
+void _rf__ui_access_push(rf_UIState *ui, uint32_t node) {
+    rf_UIAccessTree *tree = ui->access_tree;
+    if(tree) {
+        if(tree->parent_count < RF_UI_ACCESS_STACK_SIZE) {
+            tree->parents[tree->parent_count] = node;
+        }
+        ++tree->parent_count;
+    }
+}
+
+void _rf__ui_access_pop(rf_UIState *ui) {
+    if(ui->access_tree && ui->access_tree->parent_count) {
+        --ui->access_tree->parent_count;
+    }
+}
+
+int _rf__ui_access_label_is(const rf_UIAccessTree *tree, uint32_t index, const char *label, uint32_t len) {
+    const rf_UIAccessNode *node = tree->nodes + index;
+    if(node->label_len != len) {
+        return 0;
+    }
+    for(uint32_t i = 0; i < len; ++i) {
+        if(tree->text[node->label_offset + i] != label[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// rebuilds the ID and label tables for this frame's nodes; both map a slot
+// to a node's index + 1, and the first node with a given key keeps the slot
+void _rf__ui_index_access_tree(rf_UIAccessTree *tree) {
+    uint32_t cap = _RF_UI_ARRAY_START_CAP;
+    while(cap < tree->node_count * 2) {
+        cap *= 2;
+    }
+    if(tree->index_cap != cap) {
+        tree->id_index = (uint32_t *)RF_UI_REALLOC(tree->id_index, cap * sizeof(uint32_t));
+        tree->label_index = (uint32_t *)RF_UI_REALLOC(tree->label_index, cap * sizeof(uint32_t));
+        tree->index_cap = cap;
+    }
+    for(uint32_t i = 0; i < cap; ++i) {
+        tree->id_index[i] = 0;
+        tree->label_index[i] = 0;
+    }
+
+    uint32_t mask = cap - 1;
+    for(uint32_t i = 0; i < tree->node_count; ++i) {
+        rf_UIAccessNode *node = tree->nodes + i;
+        uint32_t slot = (uint32_t)node->id & mask;
+        while(tree->id_index[slot] && tree->nodes[tree->id_index[slot]-1].id != node->id) {
+            slot = (slot + 1) & mask;
+        }
+        if(!tree->id_index[slot]) {
+            tree->id_index[slot] = i + 1;
+        }
+
+        if(node->label_len) {
+            const char *label = tree->text + node->label_offset;
+            slot = (uint32_t)rf_ui_hash(label, node->label_len, 0) & mask;
+            while(tree->label_index[slot] && !_rf__ui_access_label_is(tree, tree->label_index[slot]-1, label, node->label_len)) {
+                slot = (slot + 1) & mask;
+            }
+            if(!tree->label_index[slot]) {
+                tree->label_index[slot] = i + 1;
+            }
+        }
+    }
+    tree->indexed = 1;
+}
+
+const rf_UIAccessNode *rf_ui_access_find(const rf_UIAccessTree *tree, rf_ui_id id) {
+    if(!tree->indexed) {
+        return NULL;
+    }
+    uint32_t mask = tree->index_cap - 1;
+    for(uint32_t slot = (uint32_t)id & mask; tree->id_index[slot]; slot = (slot + 1) & mask) {
+        if(tree->nodes[tree->id_index[slot]-1].id == id) {
+            return tree->nodes + tree->id_index[slot] - 1;
+        }
+    }
+    return NULL;
+}
+
+const rf_UIAccessNode *rf_ui_access_find_label(const rf_UIAccessTree *tree, const char *label) {
+    if(!tree->indexed) {
+        return NULL;
+    }
+    uint32_t len = _rf__ui_strlen((char *)label),
+             mask = tree->index_cap - 1;
+    for(uint32_t slot = (uint32_t)rf_ui_hash(label, len, 0) & mask; tree->label_index[slot]; slot = (slot + 1) & mask) {
+        if(_rf__ui_access_label_is(tree, tree->label_index[slot]-1, label, len)) {
+            return tree->nodes + tree->label_index[slot] - 1;
+        }
+    }
+    return NULL;
+}
+
+void _rf__ui_merge_access_tree(rf_UIAccessTree *tree, rf_UIAccessTree *from) {
+    uint32_t node_base = tree->node_count,
+             text_base = tree->text_size;
+
+    tree->text = (char *)_rf__ui_grow(tree->text, &tree->text_cap, 1, text_base + from->text_size);
+    for(uint32_t i = 0; i < from->text_size; ++i) {
+        tree->text[text_base + i] = from->text[i];
+    }
+    tree->text_size += from->text_size;
+
+    tree->nodes = (rf_UIAccessNode *)_rf__ui_grow(tree->nodes, &tree->node_cap, sizeof(rf_UIAccessNode),
+                                                  node_base + from->node_count);
+    for(uint32_t i = 0; i < from->node_count; ++i) {
+        rf_UIAccessNode *node = tree->nodes + node_base + i;
+        *node = from->nodes[i];
+        node->parent = node->parent ? node->parent + node_base : 0;
+        node->label_offset += text_base;
+        node->text_offset += text_base;
+    }
+    tree->node_count += from->node_count;
+}
+
+void _rf__ui_draw_widget_rect(rf_UIState *ui, rf_ui_id id, uint8_t style, float x, float y, float w, float h) {
+    if(ui->draw_list) {
+        uint16_t flags = id ? (ui->hot == id ? RF_UI_DRAW_HOT : 0) | (ui->active == id ? RF_UI_DRAW_ACTIVE : 0) : 0;
+        rf_UICommand *command = _rf__ui_push_command(ui, RF_UI_COMMAND_RECT, style, flags,
+                                                     _rf__ui_style_color(ui->draw_list, style, flags));
+        command->id = id;
+        command->x = x;
+        command->y = y;
+        command->w = w;
+        command->h = h;
+    }
+}
+
+void _rf__ui_draw_widget_text(rf_UIState *ui, rf_ui_id id, uint8_t style, float x, float y, const char *text, uint32_t text_len, uint32_t color) {
+    rf_UIDrawList *list = ui->draw_list;
+    if(list && text_len) {
+        list->text = (char *)_rf__ui_grow(list->text, &list->text_cap, 1, list->text_size + text_len);
+        for(uint32_t i = 0; i < text_len; ++i) {
+            list->text[list->text_size + i] = text[i];
+        }
+
+        uint16_t flags = id ? (ui->hot == id ? RF_UI_DRAW_HOT : 0) | (ui->active == id ? RF_UI_DRAW_ACTIVE : 0) : 0;
+        rf_UICommand *command = _rf__ui_push_command(ui, RF_UI_COMMAND_TEXT, style, flags,
+                                                     color ? color : _rf__ui_style_color(list, style, flags));
+        command->id = id;
+        command->text_offset = list->text_size;
+        command->text_len = text_len;
+        command->x = x;
+        command->y = y;
+        command->w = 0;
+        command->h = 0;
+        list->text_size += text_len;
+    }
+}
+
+void rf_ui_draw_rect(rf_UIState *ui, float x, float y, float w, float h, uint32_t color) {
+    if(ui->draw_list) {
+        rf_UICommand *command = _rf__ui_push_command(ui, RF_UI_COMMAND_RECT, RF_UI_STYLE_CUSTOM, 0, color);
+        command->x = x;
+        command->y = y;
+        command->w = w;
+        command->h = h;
+    }
+}
+
+void rf_ui_draw_line(rf_UIState *ui, float x0, float y0, float x1, float y1, float thickness, uint32_t color) {
+    if(ui->draw_list) {
+        rf_UICommand *command = _rf__ui_push_command(ui, RF_UI_COMMAND_LINE, RF_UI_STYLE_CUSTOM, 0, color);
+        command->x = x0;
+        command->y = y0;
+        command->w = x1;
+        command->h = y1;
+        command->thickness = thickness;
+    }
+}
+
+void rf_ui_draw_text(rf_UIState *ui, float x, float y, const char *text, uint32_t color) {
+    _rf__ui_draw_widget_text(ui, 0, RF_UI_STYLE_CUSTOM, x, y, text, _rf__ui_strlen((char *)text), color);
+}
+
+void _rf__ui_push_quad(rf_UIDrawList *list, float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3,
+                       float u0, float v0, float u1, float v1, uint32_t color) {
+    list->vertices = (rf_UIVertex *)_rf__ui_grow(list->vertices, &list->vertex_cap, sizeof(rf_UIVertex), list->vertex_count + 4);
+    list->indices = (uint32_t *)_rf__ui_grow(list->indices, &list->index_cap, sizeof(uint32_t), list->index_count + 6);
+
+    rf_UIVertex *v = list->vertices + list->vertex_count;
+    v[0].x = x0; v[0].y = y0; v[0].u = u0; v[0].v = v0; v[0].color = color;
+    v[1].x = x1; v[1].y = y1; v[1].u = u1; v[1].v = v0; v[1].color = color;
+    v[2].x = x2; v[2].y = y2; v[2].u = u1; v[2].v = v1; v[2].color = color;
+    v[3].x = x3; v[3].y = y3; v[3].u = u0; v[3].v = v1; v[3].color = color;
+
+    uint32_t *i = list->indices + list->index_count;
+    i[0] = list->vertex_count;
+    i[1] = list->vertex_count + 1;
+    i[2] = list->vertex_count + 2;
+    i[3] = list->vertex_count;
+    i[4] = list->vertex_count + 2;
+    i[5] = list->vertex_count + 3;
+
+    list->vertex_count += 4;
+    list->index_count += 6;
+}
+
+void rf_ui_build_vertices(rf_UIDrawList *list, float white_u, float white_v, rf_UIGlyphFunc glyph_func, void *user_data) {
+    list->vertex_count = 0;
+    list->index_count = 0;
+    list->batch_count = 0;
+
+    uint32_t batch_clip = (uint32_t)-1;
+
+    for(uint32_t c = 0; c < list->command_count; ++c) {
+        rf_UICommand *command = list->commands + c;
+        float *clip = list->clips + 4 * command->clip;
+
+        if(command->type == RF_UI_COMMAND_RECT &&
+           (command->x >= clip[0] + clip[2] || command->x + command->w <= clip[0] ||
+            command->y >= clip[1] + clip[3] || command->y + command->h <= clip[1])) {
+            continue;
+        }
+
+        if(command->clip != batch_clip) {
+            if(!list->batch_count || list->batches[list->batch_count-1].index_count) {
+                list->batches = (rf_UIDrawBatch *)_rf__ui_grow(list->batches, &list->batch_cap, sizeof(rf_UIDrawBatch), list->batch_count + 1);
+                ++list->batch_count;
+            }
+            rf_UIDrawBatch *batch = list->batches + list->batch_count - 1;
+            batch->clip_x = clip[0];
+            batch->clip_y = clip[1];
+            batch->clip_w = clip[2];
+            batch->clip_h = clip[3];
+            batch->index_offset = list->index_count;
+            batch->index_count = 0;
+            batch_clip = command->clip;
+        }
+
+        uint32_t index_start = list->index_count;
+
+        switch(command->type) {
+            case RF_UI_COMMAND_RECT: {
+                float x1 = command->x + command->w,
+                      y1 = command->y + command->h;
+                _rf__ui_push_quad(list, command->x, command->y, x1, command->y, x1, y1, command->x, y1,
+                                  white_u, white_v, white_u, white_v, command->color);
+                break;
+            }
+            case RF_UI_COMMAND_LINE: {
+                float dx = command->w - command->x,
+                      dy = command->h - command->y;
+                float length = _rf__ui_sqrt(dx*dx + dy*dy);
+                if(length > 0) {
+                    float nx = -dy * command->thickness * 0.5f / length,
+                          ny = dx * command->thickness * 0.5f / length;
+                    _rf__ui_push_quad(list,
+                                      command->x + nx, command->y + ny,
+                                      command->w + nx, command->h + ny,
+                                      command->w - nx, command->h - ny,
+                                      command->x - nx, command->y - ny,
+                                      white_u, white_v, white_u, white_v, command->color);
+                }
+                break;
+            }
+            case RF_UI_COMMAND_TEXT: {
+                if(glyph_func) {
+                    const char *text = list->text + command->text_offset;
+                    float x = command->x;
+                    for(uint32_t i = 0; i < command->text_len;) {
+                        uint32_t codepoint = 0;
+                        i += _rf__ui_utf8_decode(text + i, command->text_len - i, &codepoint);
+
+                        float quad[4] = { 0, 0, 0, 0 },
+                              uv[4] = { 0, 0, 0, 0 };
+                        float advance = glyph_func(user_data, codepoint, x, command->y, quad, uv);
+                        if(quad[2] > quad[0] && quad[3] > quad[1] &&
+                           quad[2] > clip[0] && quad[0] < clip[0] + clip[2] &&
+                           quad[3] > clip[1] && quad[1] < clip[1] + clip[3]) {
+                            _rf__ui_push_quad(list, quad[0], quad[1], quad[2], quad[1], quad[2], quad[3], quad[0], quad[3],
+                                              uv[0], uv[1], uv[2], uv[3], command->color);
+                        }
+                        x += advance;
+                    }
+                }
+                break;
+            }
+            default: break;
+        }
+
+        list->batches[list->batch_count-1].index_count += list->index_count - index_start;
+    }
+
+    if(list->batch_count && !list->batches[list->batch_count-1].index_count) {
+        --list->batch_count;
+    }
+}
+
+rf_UIRect rf_ui_rect(float x, float y, float w, float h) {
+    rf_UIRect rect;
+    rect.x = x;
+    rect.y = y;
+    rect.w = w;
+    rect.h = h;
+    return rect;
+}
+
+rf_UISize rf_ui_pixels(float pixels) {
+    rf_UISize size;
+    size.kind = RF_UI_SIZE_PIXELS;
+    size.value = pixels;
+    return size;
+}
+
+rf_UISize rf_ui_fraction(float fraction) {
+    rf_UISize size;
+    size.kind = RF_UI_SIZE_FRACTION;
+    size.value = fraction;
+    return size;
+}
+
+rf_UISize rf_ui_auto(void) {
+    rf_UISize size;
+    size.kind = RF_UI_SIZE_AUTO;
+    size.value = 1.f;
+    return size;
+}
+
+void _rf__ui_layout_open(rf_UIState *ui, rf_ui_id id, int direction, rf_UIRect rect, unsigned int columns, float cell_h) {
+    if(ui->layout_stack_size >= RF_UI_LAYOUT_STACK_SIZE) {
+        ++ui->layout_overflow;
+        return;
+    }
+
+    rf_UILayout *layout = ui->layout_stack + ui->layout_stack_size++;
+    float padding = ui->layout_padding;
+
+    layout->id = id;
+    layout->direction = (uint8_t)direction;
+    layout->x = rect.x + padding;
+    layout->y = rect.y + padding;
+    layout->w = rect.w > 2*padding ? rect.w - 2*padding : 0;
+    layout->h = rect.h > 2*padding ? rect.h - 2*padding : 0;
+    layout->spacing = ui->layout_spacing;
+    layout->cursor = 0;
+    layout->fixed_total = 0;
+    layout->fraction_total = 0;
+    layout->child_count = 0;
+    layout->columns = columns ? columns : 1;
+    layout->cell_h = cell_h;
+
+    rf_UIWidgetState *state = rf_ui_get_state(ui, id);
+    layout->cached_fixed_total = state->f[0];
+    layout->cached_fraction_total = state->f[1];
+    layout->cached_child_count = (uint32_t)state->i[0];
+}
+
+float _rf__ui_layout_main_extent(rf_UILayout *layout) {
+    return layout->direction == RF_UI_LAYOUT_ROW ? layout->w : layout->h;
+}
+
+rf_UIRect rf_ui_layout_next(rf_UIState *ui, rf_UISize size) {
+    if(!ui->layout_stack_size || ui->layout_overflow) {
+        return rf_ui_rect(0, 0, 0, 0);
+    }
+
+    rf_UILayout *layout = ui->layout_stack + ui->layout_stack_size - 1;
+    rf_UIRect rect;
+
+    if(layout->direction == RF_UI_LAYOUT_GRID) {
+        uint32_t column = layout->child_count % layout->columns,
+                 row = layout->child_count / layout->columns;
+        float cell_w = (layout->w - layout->spacing * (layout->columns - 1)) / layout->columns;
+        rect.x = layout->x + column * (cell_w + layout->spacing);
+        rect.y = layout->y + row * (layout->cell_h + layout->spacing);
+        rect.w = cell_w > 0 ? cell_w : 0;
+        rect.h = layout->cell_h;
+        ++layout->child_count;
+        layout->cursor = (row + 1) * (layout->cell_h + layout->spacing);
+        return rect;
+    }
+
+    float extent = 0;
+    if(size.kind == RF_UI_SIZE_PIXELS) {
+        extent = size.value;
+        layout->fixed_total += extent;
+    }
+    else {
+        float fraction_total = layout->cached_fraction_total > 0 ? layout->cached_fraction_total : size.value;
+        uint32_t child_count = layout->cached_child_count > layout->child_count + 1 ?
+                               layout->cached_child_count : layout->child_count + 1;
+        float remaining = _rf__ui_layout_main_extent(layout) - layout->cached_fixed_total -
+                          layout->spacing * (child_count - 1);
+        extent = remaining > 0 ? remaining * size.value / fraction_total : 0;
+        layout->fraction_total += size.value;
+
+        // until last frame's totals are known, fractions can add up to more
+        // than the layout has, so never hand out more than is left
+        float left = _rf__ui_layout_main_extent(layout) - layout->cursor -
+                     (layout->child_count ? layout->spacing : 0);
+        if(extent > left) {
+            extent = left > 0 ? left : 0;
+        }
+    }
+
+    if(layout->child_count) {
+        layout->cursor += layout->spacing;
+    }
+
+    if(layout->direction == RF_UI_LAYOUT_ROW) {
+        rect.x = layout->x + layout->cursor;
+        rect.y = layout->y;
+        rect.w = extent;
+        rect.h = layout->h;
+    }
+    else {
+        rect.x = layout->x;
+        rect.y = layout->y + layout->cursor;
+        rect.w = layout->w;
+        rect.h = extent;
+    }
+
+    layout->cursor += extent;
+    ++layout->child_count;
+    return rect;
+}
+
+void rf_ui_layout_begin(rf_UIState *ui, rf_ui_id id, int direction, rf_UIRect rect) {
+    _rf__ui_layout_open(ui, id, direction, rect, 1, 0);
+}
+
+void rf_ui_layout_push(rf_UIState *ui, rf_ui_id id, int direction, rf_UISize size) {
+    if(size.kind == RF_UI_SIZE_AUTO && ui->layout_stack_size && !ui->layout_overflow) {
+        rf_UILayout *parent = ui->layout_stack + ui->layout_stack_size - 1;
+        int parent_vertical = parent->direction != RF_UI_LAYOUT_ROW,
+            child_vertical = direction != RF_UI_LAYOUT_ROW;
+        rf_UIWidgetState *state = rf_ui_find_state(ui, id);
+        if(parent_vertical == child_vertical && state) {
+            size = rf_ui_pixels(state->f[2] + 2*ui->layout_padding);
+        }
+    }
+    _rf__ui_layout_open(ui, id, direction, rf_ui_layout_next(ui, size), 1, 0);
+}
+
+void rf_ui_layout_grid(rf_UIState *ui, rf_ui_id id, unsigned int columns, float cell_h, rf_UISize size) {
+    if(size.kind == RF_UI_SIZE_AUTO && ui->layout_stack_size && !ui->layout_overflow) {
+        rf_UILayout *parent = ui->layout_stack + ui->layout_stack_size - 1;
+        rf_UIWidgetState *state = rf_ui_find_state(ui, id);
+        if(parent->direction != RF_UI_LAYOUT_ROW && state) {
+            size = rf_ui_pixels(state->f[2] + 2*ui->layout_padding);
+        }
+    }
+    _rf__ui_layout_open(ui, id, RF_UI_LAYOUT_GRID, rf_ui_layout_next(ui, size), columns, cell_h);
+}
+
+void rf_ui_layout_pop(rf_UIState *ui) {
+    if(ui->layout_overflow) {
+        --ui->layout_overflow;
+        return;
+    }
+    if(!ui->layout_stack_size) {
+        return;
+    }
+
+    rf_UILayout *layout = ui->layout_stack + --ui->layout_stack_size;
+    rf_UIWidgetState *state = rf_ui_get_state(ui, layout->id);
+    state->f[0] = layout->fixed_total;
+    state->f[1] = layout->fraction_total;
+    state->f[2] = layout->direction == RF_UI_LAYOUT_GRID && layout->cursor > 0 ?
+                  layout->cursor - layout->spacing : layout->cursor;
+    state->i[0] = (int32_t)layout->child_count;
+}
+
+void _rf__ui_init_state(rf_UIState *ui) {
+    ui->hot = 0;
+    ui->active = 0;
+
+    ui->id_stack_size = 0;
+
+    ui->frame = 0;
+
+    ui->draw_list = NULL;
+    ui->access_tree = NULL;
+    ui->access_label = NULL;
+    ui->clip_stack_size = 0;
+    ui->clip_overflow = 0;
+    ui->clip_index = 0;
+
+    ui->layout_stack_size = 0;
+    ui->layout_overflow = 0;
+    ui->layout_padding = 4;
+    ui->layout_spacing = 4;
+
+    ui->layer_stack_size = 0;
+    ui->layer = 0;
+    ui->hit_id = 0;
+    ui->hit_scroll_id = 0;
+    ui->scroll_hover = 0;
+    ui->hit_layer = 0;
+    ui->hit_scroll_layer = 0;
+
+    ui->states = NULL;
+    ui->state_count = 0;
+    ui->state_cap = 0;
+    ui->state_touched = 0;
+
+    ui->focus_items = NULL;
+    ui->focus_item_count = 0;
+    ui->focus_item_cap = 0;
+
+    ui->nav_cells = NULL;
+    ui->nav_items = NULL;
+    ui->nav_cell_cap = 0;
+    ui->nav_item_cap = 0;
+    ui->nav_dim = 0;
+    ui->current_focus_id = -1;
+    ui->current_focus_group = 0;
+    ui->focusing = 0;
+
+    ui->cursor_x = 0;
+    ui->cursor_y = 0;
+    ui->scroll_y = 0;
+    for(int i = 0; i < RF_MAX_UI_CONTROL; ++i) {
+        ui->controls[i] = 0;
+    }
+    ui->char_input = 0;
+
+    ui->events = NULL;
+    ui->event_count = 0;
+    ui->event_cap = 0;
+    ui->pointer_event_count = 0;
+    ui->key_event_count = 0;
+    ui->input_x = 0;
+    ui->input_y = 0;
+    for(int i = 0; i < RF_MAX_UI_CONTROL; ++i) {
+        ui->control_held[i] = 0;
+    }
+
+    ui->idle = 0;
+    ui->frame_requested = 0;
+    ui->idle_hash = 0;
+
+    ui->text_width_func = NULL;
+    ui->text_width_user = NULL;
+    ui->line_height = RF_UI_LINE_HEIGHT;
+    ui->edit_buffer = rf_ui_text_init();
+    ui->edit_id = 0;
+
+    ui->panels = NULL;
+    ui->panel_count = 0;
+    ui->panel_cap = 0;
+    ui->panel_active = 0;
+
+    ui->delta_time = 1.f / 60.f;
+    ui->anim_ids = NULL;
+    ui->anim_frames = NULL;
+    ui->anim_starts = NULL;
+    ui->anim_targets = NULL;
+    ui->anim_values = NULL;
+    ui->anim_times = NULL;
+    ui->anim_rates = NULL;
+    ui->anim_count = 0;
+    ui->anim_cap = 0;
+    ui->anim_table = NULL;
+    ui->anim_table_cap = 0;
+    ui->anim_touched = 0;
+    ui->anim_moving = 0;
+
+    ui->tree_depth = 0;
+    ui->tree_open = NULL;
+    ui->tree_open_count = 0;
+    ui->tree_open_cap = 0;
+
+    ui->windows = NULL;
+    ui->window_count = 0;
+    ui->window_cap = 0;
+    ui->window_depth = 0;
+    ui->docks = NULL;
+    ui->dock_count = 0;
+    ui->dock_cap = 0;
+    ui->window_commands = NULL;
+    ui->window_command_cap = 0;
+    ui->window_hit_id = 0;
+    ui->window_hover = 0;
+    ui->window_hit_layer = 0;
+    ui->window_z = 0;
+    ui->window_drag_x = 0;
+    ui->window_drag_y = 0;
+}
+
+rf_UIState rf_ui_init(void) {
+    rf_UIState ui;
+    _rf__ui_init_state(&ui);
+    return ui;
+}
+
+rf_UIArena rf_ui_arena_init(void *memory, size_t size) {
+    rf_UIArena arena;
+    arena.memory = (uint8_t *)memory;
+    arena.size = size;
+    arena.used = 0;
+    return arena;
+}
+
+rf_UIState *rf_ui_arena_push_state(rf_UIArena *arena) {
+    uintptr_t base = (uintptr_t)arena->memory,
+              at = (base + arena->used + _RF_UI_ARENA_ALIGN - 1) & ~(uintptr_t)(_RF_UI_ARENA_ALIGN - 1);
+    size_t offset = (size_t)(at - base);
+    if(offset > arena->size || arena->size - offset < sizeof(rf_UIState)) {
+        return NULL;
+    }
+
+    rf_UIState *ui = (rf_UIState *)(arena->memory + offset);
+    arena->used = offset + sizeof(rf_UIState);
+    _rf__ui_init_state(ui);
+    return ui;
+}
+
+void rf_ui_clean_up(rf_UIState *ui) {
+    RF_UI_FREE(ui->focus_items);
+    ui->focus_items = NULL;
+    ui->focus_item_count = 0;
+    ui->focus_item_cap = 0;
+
+    RF_UI_FREE(ui->nav_cells);
+    RF_UI_FREE(ui->nav_items);
+    ui->nav_cells = NULL;
+    ui->nav_items = NULL;
+    ui->nav_cell_cap = 0;
+    ui->nav_item_cap = 0;
+
+    RF_UI_FREE(ui->states);
+    ui->states = NULL;
+    ui->state_count = 0;
+    ui->state_cap = 0;
+
+    RF_UI_FREE(ui->events);
+    ui->events = NULL;
+    ui->event_count = 0;
+    ui->event_cap = 0;
+
+    rf_ui_text_clean_up(&ui->edit_buffer);
+    ui->edit_id = 0;
+
+    RF_UI_FREE(ui->panels);
+    ui->panels = NULL;
+    ui->panel_count = 0;
+    ui->panel_cap = 0;
+
+    RF_UI_FREE(ui->anim_ids);
+    RF_UI_FREE(ui->anim_frames);
+    RF_UI_FREE(ui->anim_starts);
+    RF_UI_FREE(ui->anim_targets);
+    RF_UI_FREE(ui->anim_values);
+    RF_UI_FREE(ui->anim_times);
+    RF_UI_FREE(ui->anim_rates);
+    RF_UI_FREE(ui->anim_table);
+    ui->anim_ids = NULL;
+    ui->anim_frames = NULL;
+    ui->anim_starts = NULL;
+    ui->anim_targets = NULL;
+    ui->anim_values = NULL;
+    ui->anim_times = NULL;
+    ui->anim_rates = NULL;
+    ui->anim_table = NULL;
+    ui->anim_count = 0;
+    ui->anim_cap = 0;
+    ui->anim_table_cap = 0;
+
+    RF_UI_FREE(ui->tree_open);
+    ui->tree_open = NULL;
+    ui->tree_open_count = 0;
+    ui->tree_open_cap = 0;
+
+    RF_UI_FREE(ui->windows);
+    RF_UI_FREE(ui->docks);
+    RF_UI_FREE(ui->window_commands);
+    ui->windows = NULL;
+    ui->docks = NULL;
+    ui->window_commands = NULL;
+    ui->window_count = 0;
+    ui->window_cap = 0;
+    ui->dock_count = 0;
+    ui->dock_cap = 0;
+    ui->window_command_cap = 0;
+}
+
+void rf_ui_begin(rf_UIState *ui) {
+    ui->cursor_x = ui->input_x;
+    ui->cursor_y = ui->input_y;
+    ui->scroll_y = 0;
+    for(int i = 0; i < RF_MAX_UI_CONTROL; ++i) {
+        ui->controls[i] = ui->control_held[i];
+    }
+    ui->char_input = 0;
+    ui->focus_item_count = 0;
+    ui->id_stack_size = 0;
+    ++ui->frame;
+    ui->state_touched = 0;
+    ui->anim_touched = 0;
+
+    ui->clip_stack_size = 0;
+    ui->clip_overflow = 0;
+    ui->clip_index = 0;
+    ui->layout_stack_size = 0;
+    ui->layout_overflow = 0;
+    ui->layer_stack_size = 0;
+    ui->layer = 0;
+    ui->hit_id = 0;
+    ui->hit_scroll_id = 0;
+    ui->tree_depth = 0;
+    ui->window_count = 0;
+    ui->window_depth = 0;
+    ui->dock_count = 0;
+    ui->window_hit_id = 0;
+    ui->window_hit_layer = 0;
+    if(ui->draw_list) {
+        _rf__ui_draw_list_reset(ui->draw_list);
+    }
+    if(ui->access_tree) {
+        _rf__ui_access_tree_reset(ui->access_tree);
+    }
+    ui->access_label = NULL;
+}
+
+uint32_t _rf__ui_nav_cell(rf_UIState *ui, rf_UIFocusItem *item);
+
+int _rf__ui_control_is_held(int control) {
+    return control == RF_UI_CONTROL_LEFT_MOUSE ||
+           control == RF_UI_CONTROL_RIGHT_MOUSE ||
+           control == RF_UI_CONTROL_UP_HOLD ||
+           control == RF_UI_CONTROL_LEFT_HOLD ||
+           control == RF_UI_CONTROL_DOWN_HOLD ||
+           control == RF_UI_CONTROL_RIGHT_HOLD ||
+           control == RF_UI_CONTROL_SELECT_HOLD ||
+           control == RF_UI_CONTROL_WORD_HOLD;
+}
+
+rf_UIEvent *_rf__ui_push_event(rf_UIState *ui, uint8_t type, uint32_t time) {
+    ui->events = (rf_UIEvent *)_rf__ui_grow(ui->events, &ui->event_cap, sizeof(rf_UIEvent), ui->event_count + 1);
+    rf_UIEvent *event = ui->events + ui->event_count++;
+    event->type = type;
+    event->control = 0;
+    event->down = 0;
+    event->codepoint = 0;
+    event->scroll = 0;
+    event->time = time;
+    return event;
+}
+
+void _rf__ui_finish_event(rf_UIState *ui, rf_UIEvent *event) {
+    event->x = ui->input_x;
+    event->y = ui->input_y;
+    event->buttons = ui->control_held[RF_UI_CONTROL_LEFT_MOUSE] |
+                     ui->control_held[RF_UI_CONTROL_RIGHT_MOUSE] << 1;
+    event->modifiers = ui->control_held[RF_UI_CONTROL_SELECT_HOLD] |
+                       ui->control_held[RF_UI_CONTROL_WORD_HOLD] << 1;
+}
+
+void rf_ui_input_control(rf_UIState *ui, int control, int down, uint32_t time) {
+    if(control < 0 || control >= RF_MAX_UI_CONTROL) {
+        return;
+    }
+    rf_UIEvent *event = _rf__ui_push_event(ui, RF_UI_EVENT_CONTROL, time);
+    event->control = (uint8_t)control;
+    event->down = down != 0;
+    if(_rf__ui_control_is_held(control)) {
+        ui->control_held[control] = down != 0;
+        ui->controls[control] = down != 0;
+    }
+    else if(down) {
+        ++ui->controls[control];
+    }
+    _rf__ui_finish_event(ui, event);
+
+    if(control == RF_UI_CONTROL_LEFT_MOUSE || control == RF_UI_CONTROL_RIGHT_MOUSE) {
+        ++ui->pointer_event_count;
+    }
+    else if(down) {
+        ++ui->key_event_count;
+    }
+}
+
+void rf_ui_input_text(rf_UIState *ui, uint32_t codepoint, uint32_t time) {
+    rf_UIEvent *event = _rf__ui_push_event(ui, RF_UI_EVENT_TEXT, time);
+    event->codepoint = codepoint;
+    _rf__ui_finish_event(ui, event);
+    if(!ui->char_input && codepoint < 128) {
+        ui->char_input = (char)codepoint;
+    }
+    ++ui->key_event_count;
+}
+
+void rf_ui_input_cursor(rf_UIState *ui, float x, float y, uint32_t time) {
+    rf_UIEvent *event = _rf__ui_push_event(ui, RF_UI_EVENT_CURSOR, time);
+    ui->cursor_x = ui->input_x = x;
+    ui->cursor_y = ui->input_y = y;
+    _rf__ui_finish_event(ui, event);
+    ++ui->pointer_event_count;
+}
+
+void rf_ui_input_scroll(rf_UIState *ui, float scroll_y, uint32_t time) {
+    rf_UIEvent *event = _rf__ui_push_event(ui, RF_UI_EVENT_SCROLL, time);
+    event->scroll = scroll_y;
+    ui->scroll_y += scroll_y;
+    _rf__ui_finish_event(ui, event);
+}
+
+rf_UIRecording rf_ui_recording_init(void) {
+    rf_UIRecording rec;
+    rec.frames = NULL;
+    rec.frame_count = rec.frame_cap = 0;
+    rec.controls = NULL;
+    rec.held = NULL;
+    rec.control_cap = rec.held_cap = 0;
+    rec.events = NULL;
+    rec.event_count = rec.event_cap = 0;
+    return rec;
+}
+
+void rf_ui_recording_clean_up(rf_UIRecording *rec) {
+    RF_UI_FREE(rec->frames);
+    RF_UI_FREE(rec->controls);
+    RF_UI_FREE(rec->held);
+    RF_UI_FREE(rec->events);
+    *rec = rf_ui_recording_init();
+}
+
+void rf_ui_record_frame(rf_UIState *ui, rf_UIRecording *rec) {
+    uint32_t index = rec->frame_count;
+    rec->frames = (rf_UIRecordedFrame *)_rf__ui_grow(rec->frames, &rec->frame_cap, sizeof(rf_UIRecordedFrame), index + 1);
+    rec->controls = (int32_t *)_rf__ui_grow(rec->controls, &rec->control_cap, sizeof(int32_t) * RF_MAX_UI_CONTROL, index + 1);
+    rec->held = (uint8_t *)_rf__ui_grow(rec->held, &rec->held_cap, RF_MAX_UI_CONTROL, index + 1);
+    rec->events = (rf_UIEvent *)_rf__ui_grow(rec->events, &rec->event_cap, sizeof(rf_UIEvent), rec->event_count + ui->event_count);
+    ++rec->frame_count;
+
+    rf_UIRecordedFrame *frame = rec->frames + index;
+    frame->cursor_x = ui->cursor_x;
+    frame->cursor_y = ui->cursor_y;
+    frame->input_x = ui->input_x;
+    frame->input_y = ui->input_y;
+    frame->scroll_y = ui->scroll_y;
+    frame->delta_time = ui->delta_time;
+    frame->char_input = ui->char_input;
+    frame->event_offset = rec->event_count;
+    frame->event_count = ui->event_count;
+
+    for(int i = 0; i < RF_MAX_UI_CONTROL; ++i) {
+        rec->controls[index * RF_MAX_UI_CONTROL + i] = ui->controls[i];
+        rec->held[index * RF_MAX_UI_CONTROL + i] = ui->control_held[i];
+    }
+    for(uint32_t i = 0; i < ui->event_count; ++i) {
+        rec->events[rec->event_count++] = ui->events[i];
+    }
+}
+
+int rf_ui_replay_frame(rf_UIState *ui, const rf_UIRecording *rec, uint32_t frame) {
+    if(frame >= rec->frame_count) {
+        return 0;
+    }
+
+    const rf_UIRecordedFrame *recorded = rec->frames + frame;
+    ui->cursor_x = recorded->cursor_x;
+    ui->cursor_y = recorded->cursor_y;
+    ui->input_x = recorded->input_x;
+    ui->input_y = recorded->input_y;
+    ui->scroll_y = recorded->scroll_y;
+    ui->delta_time = recorded->delta_time;
+    ui->char_input = recorded->char_input;
+    for(int i = 0; i < RF_MAX_UI_CONTROL; ++i) {
+        ui->controls[i] = rec->controls[frame * RF_MAX_UI_CONTROL + i];
+        ui->control_held[i] = rec->held[frame * RF_MAX_UI_CONTROL + i];
+    }
+
+    // the queue is replaced rather than appended to, and its counts are
+    // worked out the same way rf_ui_input_* does
+    ui->events = (rf_UIEvent *)_rf__ui_grow(ui->events, &ui->event_cap, sizeof(rf_UIEvent), recorded->event_count);
+    ui->event_count = recorded->event_count;
+    ui->pointer_event_count = 0;
+    ui->key_event_count = 0;
+    for(uint32_t i = 0; i < recorded->event_count; ++i) {
+        rf_UIEvent *event = ui->events + i;
+        *event = rec->events[recorded->event_offset + i];
+        if(event->type == RF_UI_EVENT_CURSOR ||
+           (event->type == RF_UI_EVENT_CONTROL &&
+            (event->control == RF_UI_CONTROL_LEFT_MOUSE || event->control == RF_UI_CONTROL_RIGHT_MOUSE))) {
+            ++ui->pointer_event_count;
+        }
+        else if(event->type == RF_UI_EVENT_TEXT || (event->type == RF_UI_EVENT_CONTROL && event->down)) {
+            ++ui->key_event_count;
+        }
+    }
+    return 1;
+}
+
+#define _RF_UI_RECORDING_VERSION 2
+#define _RF_UI_RECORDED_FRAME_SIZE 29
+#define _RF_UI_RECORDED_EVENT_SIZE 25
+
+typedef union _rf__UIFloatBits {
+    float f;
+    uint32_t u;
+} _rf__UIFloatBits;
+
+void _rf__ui_put_u32(uint8_t **p, uint32_t value) {
+    for(int i = 0; i < 4; ++i) {
+        *(*p)++ = (uint8_t)(value >> (8 * i));
+    }
+}
+
+void _rf__ui_put_f32(uint8_t **p, float value) {
+    _rf__UIFloatBits bits;
+    bits.f = value;
+    _rf__ui_put_u32(p, bits.u);
+}
+
+uint32_t _rf__ui_get_u32(const uint8_t **p) {
+    uint32_t value = 0;
+    for(int i = 0; i < 4; ++i) {
+        value |= (uint32_t)*(*p)++ << (8 * i);
+    }
+    return value;
+}
+
+float _rf__ui_get_f32(const uint8_t **p) {
+    _rf__UIFloatBits bits;
+    bits.u = _rf__ui_get_u32(p);
+    return bits.f;
+}
+
+// the format is little-endian and doesn't depend on struct layout:
+//
+//     "RFUI", version, control count, frame count, event count
+//     per frame: cursor, input position, scroll, delta time, char input,
+//                event count, then every control's value and held state
+//     per event: type, control, down, buttons, modifiers, codepoint,
+//                x, y, scroll, time
+uint32_t rf_ui_recording_save(const rf_UIRecording *rec, void **data) {
+    uint32_t size = 20 +
+                    rec->frame_count * (_RF_UI_RECORDED_FRAME_SIZE + 5 * RF_MAX_UI_CONTROL) +
+                    rec->event_count * _RF_UI_RECORDED_EVENT_SIZE;
+    uint8_t *out = (uint8_t *)RF_UI_REALLOC(NULL, size),
+            *p = out;
+    *data = out;
+    if(!out) {
+        return 0;
+    }
+
+    *p++ = 'R'; *p++ = 'F'; *p++ = 'U'; *p++ = 'I';
+    _rf__ui_put_u32(&p, _RF_UI_RECORDING_VERSION);
+    _rf__ui_put_u32(&p, RF_MAX_UI_CONTROL);
+    _rf__ui_put_u32(&p, rec->frame_count);
+    _rf__ui_put_u32(&p, rec->event_count);
+
+    for(uint32_t i = 0; i < rec->frame_count; ++i) {
+        const rf_UIRecordedFrame *frame = rec->frames + i;
+        _rf__ui_put_f32(&p, frame->cursor_x);
+        _rf__ui_put_f32(&p, frame->cursor_y);
+        _rf__ui_put_f32(&p, frame->input_x);
+        _rf__ui_put_f32(&p, frame->input_y);
+        _rf__ui_put_f32(&p, frame->scroll_y);
+        _rf__ui_put_f32(&p, frame->delta_time);
+        *p++ = (uint8_t)frame->char_input;
+        _rf__ui_put_u32(&p, frame->event_count);
+        for(int c = 0; c < RF_MAX_UI_CONTROL; ++c) {
+            _rf__ui_put_u32(&p, (uint32_t)rec->controls[i * RF_MAX_UI_CONTROL + c]);
+            *p++ = rec->held[i * RF_MAX_UI_CONTROL + c];
+        }
+    }
+
+    for(uint32_t i = 0; i < rec->event_count; ++i) {
+        const rf_UIEvent *event = rec->events + i;
+        *p++ = event->type;
+        *p++ = event->control;
+        *p++ = event->down;
+        *p++ = event->buttons;
+        *p++ = event->modifiers;
+        _rf__ui_put_u32(&p, event->codepoint);
+        _rf__ui_put_f32(&p, event->x);
+        _rf__ui_put_f32(&p, event->y);
+        _rf__ui_put_f32(&p, event->scroll);
+        _rf__ui_put_u32(&p, event->time);
+    }
+    return size;
+}
+
+int rf_ui_recording_load(rf_UIRecording *rec, const void *data, uint32_t size) {
+    const uint8_t *p = (const uint8_t *)data;
+    rf_ui_recording_clean_up(rec);
+    if(size < 20 || p[0] != 'R' || p[1] != 'F' || p[2] != 'U' || p[3] != 'I') {
+        return 0;
+    }
+    p += 4;
+    uint32_t version = _rf__ui_get_u32(&p),
+             control_count = _rf__ui_get_u32(&p),
+             frame_count = _rf__ui_get_u32(&p),
+             event_count = _rf__ui_get_u32(&p);
+    uint64_t frame_size = _RF_UI_RECORDED_FRAME_SIZE + 5 * (uint64_t)control_count;
+    if(version != _RF_UI_RECORDING_VERSION ||
+       20 + frame_count * frame_size + (uint64_t)event_count * _RF_UI_RECORDED_EVENT_SIZE != size) {
+        return 0;
+    }
+
+    // controls are only ever added at the end, so a recording made with
+    // fewer of them replays with the newer ones left up
+    rec->frames = (rf_UIRecordedFrame *)_rf__ui_grow(rec->frames, &rec->frame_cap, sizeof(rf_UIRecordedFrame), frame_count);
+    rec->controls = (int32_t *)_rf__ui_grow(rec->controls, &rec->control_cap, sizeof(int32_t) * RF_MAX_UI_CONTROL, frame_count);
+    rec->held = (uint8_t *)_rf__ui_grow(rec->held, &rec->held_cap, RF_MAX_UI_CONTROL, frame_count);
+    rec->events = (rf_UIEvent *)_rf__ui_grow(rec->events, &rec->event_cap, sizeof(rf_UIEvent), event_count);
+
+    uint32_t event_offset = 0;
+    for(uint32_t i = 0; i < frame_count; ++i) {
+        rf_UIRecordedFrame *frame = rec->frames + i;
+        frame->cursor_x = _rf__ui_get_f32(&p);
+        frame->cursor_y = _rf__ui_get_f32(&p);
+        frame->input_x = _rf__ui_get_f32(&p);
+        frame->input_y = _rf__ui_get_f32(&p);
+        frame->scroll_y = _rf__ui_get_f32(&p);
+        frame->delta_time = _rf__ui_get_f32(&p);
+        frame->char_input = (char)*p++;
+        frame->event_count = _rf__ui_get_u32(&p);
+        frame->event_offset = event_offset;
+        if(frame->event_count > event_count - event_offset) {
+            rf_ui_recording_clean_up(rec);
+            return 0;
+        }
+        event_offset += frame->event_count;
+
+        for(uint32_t c = 0; c < control_count || c < RF_MAX_UI_CONTROL; ++c) {
+            int32_t value = 0;
+            uint8_t held = 0;
+            if(c < control_count) {
+                value = (int32_t)_rf__ui_get_u32(&p);
+                held = *p++;
+            }
+            if(c < RF_MAX_UI_CONTROL) {
+                rec->controls[i * RF_MAX_UI_CONTROL + c] = value;
+                rec->held[i * RF_MAX_UI_CONTROL + c] = held;
+            }
+        }
+    }
+
+    for(uint32_t i = 0; i < event_count; ++i) {
+        rf_UIEvent *event = rec->events + i;
+        event->type = *p++;
+        event->control = *p++;
+        event->down = *p++;
+        event->buttons = *p++;
+        event->modifiers = *p++;
+        event->codepoint = _rf__ui_get_u32(&p);
+        event->x = _rf__ui_get_f32(&p);
+        event->y = _rf__ui_get_f32(&p);
+        event->scroll = _rf__ui_get_f32(&p);
+        event->time = _rf__ui_get_u32(&p);
+    }
+
+    rec->frame_count = frame_count;
+    rec->event_count = event_count;
+    return 1;
+}
+
+int _rf__ui_next_pointer(rf_UIState *ui, uint32_t *i, float *x, float *y, int *down) {
+    if(!ui->pointer_event_count) {
+        if(*i) {
+            return 0;
+        }
+        *i = 1;
+        *x = ui->cursor_x;
+        *y = ui->cursor_y;
+        *down = ui->controls[RF_UI_CONTROL_LEFT_MOUSE] != 0;
+        return 1;
+    }
+    while(*i < ui->event_count) {
+        rf_UIEvent *event = ui->events + (*i)++;
+        if(event->type == RF_UI_EVENT_CURSOR ||
+           (event->type == RF_UI_EVENT_CONTROL &&
+            (event->control == RF_UI_CONTROL_LEFT_MOUSE || event->control == RF_UI_CONTROL_RIGHT_MOUSE))) {
+            *x = event->x;
+            *y = event->y;
+            *down = event->buttons & 1;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void rf_ui_push_layer(rf_UIState *ui, int layer) {
+    if(ui->layer_stack_size < RF_UI_LAYER_STACK_SIZE) {
+        ui->layer_stack[ui->layer_stack_size++] = ui->layer;
+        ui->layer = layer;
+    }
+}
+
+void rf_ui_pop_layer(rf_UIState *ui) {
+    if(ui->layer_stack_size) {
+        ui->layer = ui->layer_stack[--ui->layer_stack_size];
+    }
+}
+
+int _rf__ui_cursor_in_clip(rf_UIState *ui) {
+    if(ui->clip_stack_size) {
+        float *clip = ui->clip_stack[ui->clip_stack_size-1];
+        return _rf__ui_cursor_over(ui, clip[0], clip[1], clip[2], clip[3]);
+    }
+    return 1;
+}
+
+int rf_ui_hit_rect(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h) {
+    if(_rf__ui_cursor_over(ui, x, y, w, h) && _rf__ui_cursor_in_clip(ui) &&
+       (!ui->hit_id || ui->layer >= ui->hit_layer)) {
+        ui->hit_id = id;
+        ui->hit_layer = ui->layer;
+    }
+    return ui->current_focus_id < 0 && ui->hot == id;
+}
+
+// widgets entirely outside the current clip rectangle skip their input logic
+// and drawing (unless they're hot or active, so drags and keyboard focus
+// survive scrolling them out of view)
+int _rf__ui_culled(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h) {
+    if(!ui->clip_stack_size || ui->hot == id || ui->active == id) {
+        return 0;
+    }
+    float *clip = ui->clip_stack[ui->clip_stack_size-1];
+    return x > clip[0] + clip[2] || x + w < clip[0] || y > clip[1] + clip[3] || y + h < clip[1];
+}
+
+void _rf__ui_hit_scroll(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h) {
+    if(_rf__ui_cursor_over(ui, x, y, w, h) && _rf__ui_cursor_in_clip(ui) &&
+       (!ui->hit_scroll_id || ui->layer >= ui->hit_scroll_layer)) {
+        ui->hit_scroll_id = id;
+        ui->hit_scroll_layer = ui->layer;
+    }
+}
+
+void _rf__ui_resolve_hits(rf_UIState *ui) {
+    if(ui->current_focus_id < 0) {
+        ui->hot = ui->hit_id;
+    }
+    ui->scroll_hover = !ui->hit_id || ui->hit_scroll_layer >= ui->hit_layer ? ui->hit_scroll_id : 0;
+}
+
+void rf_ui_request_frame(rf_UIState *ui) {
+    ui->frame_requested = 1;
+}
+
+float _rf__ui_text_width(rf_UIState *ui, const char *text, uint32_t len);
+
+rf_UIRect _rf__ui_command_bounds(rf_UIState *ui, rf_UICommand *command) {
+    rf_UIDrawList *list = ui->draw_list;
+    rf_UIRect r;
+    if(command->type == RF_UI_COMMAND_LINE) {
+        float half = command->thickness / 2;
+        r.x = (command->x < command->w ? command->x : command->w) - half;
+        r.y = (command->y < command->h ? command->y : command->h) - half;
+        r.w = (command->x < command->w ? command->w - command->x : command->x - command->w) + command->thickness;
+        r.h = (command->y < command->h ? command->h - command->y : command->y - command->h) + command->thickness;
+    }
+    else if(command->type == RF_UI_COMMAND_TEXT) {
+        r.x = command->x;
+        r.y = command->y;
+        r.w = _rf__ui_text_width(ui, list->text + command->text_offset, command->text_len);
+        r.h = ui->line_height;
+    }
+    else {
+        r.x = command->x;
+        r.y = command->y;
+        r.w = command->w;
+        r.h = command->h;
+    }
+
+    float *clip = list->clips + 4 * command->clip;
+    float x1 = r.x + r.w < clip[0] + clip[2] ? r.x + r.w : clip[0] + clip[2],
+          y1 = r.y + r.h < clip[1] + clip[3] ? r.y + r.h : clip[1] + clip[3];
+    r.x = r.x > clip[0] ? r.x : clip[0];
+    r.y = r.y > clip[1] ? r.y : clip[1];
+    r.w = x1 > r.x ? x1 - r.x : 0;
+    r.h = y1 > r.y ? y1 - r.y : 0;
+    return r;
+}
+
+uint64_t _rf__ui_command_hash(rf_UIDrawList *list, rf_UICommand *command) {
+    uint32_t header[4] = { command->type | (uint32_t)command->style << 8 | (uint32_t)command->flags << 16,
+                           command->color, command->text_len, 0 };
+    float geometry[9] = { command->x, command->y, command->w, command->h, command->thickness };
+    float *clip = list->clips + 4 * command->clip;
+    for(int i = 0; i < 4; ++i) {
+        geometry[5 + i] = clip[i];
+    }
+    uint64_t hash = rf_ui_hash(header, sizeof(header), 0);
+    hash = rf_ui_hash(geometry, sizeof(geometry), hash);
+    hash = rf_ui_hash(list->text + command->text_offset, command->text_len, hash);
+    return hash | 1;
+}
+
+int _rf__ui_hash_table_has(rf_UIDrawHashes *frame, uint64_t hash) {
+    if(!frame->table_cap) {
+        return 0;
+    }
+    uint32_t mask = frame->table_cap - 1;
+    for(uint32_t slot = (uint32_t)(hash >> 32) & mask; frame->table[slot]; slot = (slot + 1) & mask) {
+        if(frame->table[slot] == hash) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void _rf__ui_union_rect(rf_UIRect *d, rf_UIRect r) {
+    float x1 = d->x + d->w > r.x + r.w ? d->x + d->w : r.x + r.w,
+          y1 = d->y + d->h > r.y + r.h ? d->y + d->h : r.y + r.h;
+    d->x = d->x < r.x ? d->x : r.x;
+    d->y = d->y < r.y ? d->y : r.y;
+    d->w = x1 - d->x;
+    d->h = y1 - d->y;
+}
+
+void _rf__ui_add_damage(rf_UIDrawList *list, rf_UIRect r) {
+    if(r.w <= 0 || r.h <= 0) {
+        return;
+    }
+
+    for(uint32_t i = 0; i < list->damage_count; ++i) {
+        rf_UIRect *d = list->damage + i;
+        if(r.x <= d->x + d->w && d->x <= r.x + r.w && r.y <= d->y + d->h && d->y <= r.y + r.h) {
+            _rf__ui_union_rect(d, r);
+            return;
+        }
+    }
+    if(list->damage_count < RF_UI_MAX_DAMAGE_RECTS) {
+        list->damage[list->damage_count++] = r;
+        return;
+    }
+
+    // out of rectangles, so grow the one that grows the least
+    uint32_t best = 0;
+    float best_growth = 0;
+    for(uint32_t i = 0; i < list->damage_count; ++i) {
+        rf_UIRect u = list->damage[i];
+        _rf__ui_union_rect(&u, r);
+        float growth = u.w * u.h - list->damage[i].w * list->damage[i].h;
+        if(!i || growth < best_growth) {
+            best = i;
+            best_growth = growth;
+        }
+    }
+    _rf__ui_union_rect(list->damage + best, r);
+}
+
+// hashes this frame's commands and compares them to last frame's: commands
+// that only exist in one of the two frames damage their bounds
+void _rf__ui_diff_draw_list(rf_UIState *ui) {
+    rf_UIDrawList *list = ui->draw_list;
+    rf_UIDrawHashes *previous = list->frames + list->current_frame,
+                    *current = list->frames + (list->current_frame ^ 1);
+    uint32_t count = list->command_count;
+
+    current->hashes = (uint64_t *)_rf__ui_grow(current->hashes, &current->hash_cap, sizeof(uint64_t), count);
+    current->bounds = (rf_UIRect *)_rf__ui_grow(current->bounds, &current->bounds_cap, sizeof(rf_UIRect), count);
+    current->count = count;
+
+    uint32_t table_cap = _RF_UI_ARRAY_START_CAP;
+    while(table_cap < count * 2) {
+        table_cap *= 2;
+    }
+    if(current->table_cap != table_cap) {
+        current->table = (uint64_t *)RF_UI_REALLOC(current->table, table_cap * sizeof(uint64_t));
+        current->table_cap = table_cap;
+    }
+    for(uint32_t i = 0; i < table_cap; ++i) {
+        current->table[i] = 0;
+    }
+
+    list->damage_count = 0;
+    for(uint32_t i = 0; i < count; ++i) {
+        uint64_t hash = _rf__ui_command_hash(list, list->commands + i);
+        current->hashes[i] = hash;
+        current->bounds[i] = _rf__ui_command_bounds(ui, list->commands + i);
+
+        uint32_t slot = (uint32_t)(hash >> 32) & (table_cap - 1);
+        while(current->table[slot] && current->table[slot] != hash) {
+            slot = (slot + 1) & (table_cap - 1);
+        }
+        current->table[slot] = hash;
+
+        if(!_rf__ui_hash_table_has(previous, hash)) {
+            _rf__ui_add_damage(list, current->bounds[i]);
+        }
+    }
+    for(uint32_t i = 0; i < previous->count; ++i) {
+        if(!_rf__ui_hash_table_has(current, previous->hashes[i])) {
+            _rf__ui_add_damage(list, previous->bounds[i]);
+        }
+    }
+
+    list->current_frame ^= 1;
+}
+
+// decides whether running another frame without new input could change anything
+void _rf__ui_update_idle(rf_UIState *ui) {
+    int input = ui->event_count || ui->char_input || ui->scroll_y != 0;
+    rf_ui_id hash = rf_ui_hash(&ui->cursor_x, sizeof(float), 0);
+    hash = rf_ui_hash(&ui->cursor_y, sizeof(float), hash);
+    for(int i = 0; i < RF_MAX_UI_CONTROL; ++i) {
+        if(_rf__ui_control_is_held(i)) {
+            hash = rf_ui_hash(ui->controls + i, sizeof(int), hash);
+        }
+        else if(ui->controls[i]) {
+            input = 1;
+        }
+    }
+    hash = rf_ui_hash(&ui->hot, sizeof(rf_ui_id), hash);
+    hash = rf_ui_hash(&ui->active, sizeof(rf_ui_id), hash);
+    hash = rf_ui_hash(&ui->scroll_hover, sizeof(rf_ui_id), hash);
+    hash = rf_ui_hash(&ui->current_focus_id, sizeof(long int), hash);
+    hash = rf_ui_hash(&ui->current_focus_group, sizeof(long int), hash);
+
+    ui->idle = !input && !ui->frame_requested && hash == ui->idle_hash &&
+               (!ui->draw_list || !ui->draw_list->damage_count);
+    ui->idle_hash = hash;
+    ui->frame_requested = 0;
+}
+
+void _rf__ui_build_nav_grid(rf_UIState *ui) {
+    uint32_t count = ui->focus_item_count;
+    float min_x = 1e30f, min_y = 1e30f, max_x = -1e30f, max_y = -1e30f;
+
+    for(uint32_t i = 0; i < count; ++i) {
+        rf_UIFocusItem *item = ui->focus_items + i;
+        float cx = item->x + item->w/2,
+              cy = item->y + item->h/2;
+        min_x = cx < min_x ? cx : min_x;
+        min_y = cy < min_y ? cy : min_y;
+        max_x = cx > max_x ? cx : max_x;
+        max_y = cy > max_y ? cy : max_y;
+    }
+
+    uint32_t dim = 1;
+    while(dim * dim < count) {
+        ++dim;
+    }
+
+    ui->nav_dim = dim;
+    ui->nav_x = min_x;
+    ui->nav_y = min_y;
+    ui->nav_cell_w = (max_x - min_x) / dim + 1.f;
+    ui->nav_cell_h = (max_y - min_y) / dim + 1.f;
+
+    ui->nav_cells = (uint32_t *)_rf__ui_grow(ui->nav_cells, &ui->nav_cell_cap, sizeof(uint32_t), dim*dim + 1);
+    ui->nav_items = (uint32_t *)_rf__ui_grow(ui->nav_items, &ui->nav_item_cap, sizeof(uint32_t), count);
+
+    for(uint32_t i = 0; i <= dim*dim; ++i) {
+        ui->nav_cells[i] = 0;
+    }
+    for(uint32_t i = 0; i < count; ++i) {
+        ++ui->nav_cells[_rf__ui_nav_cell(ui, ui->focus_items + i) + 1];
+    }
+    for(uint32_t i = 1; i <= dim*dim; ++i) {
+        ui->nav_cells[i] += ui->nav_cells[i-1];
+    }
+    for(uint32_t i = 0; i < count; ++i) {
+        uint32_t cell = _rf__ui_nav_cell(ui, ui->focus_items + i);
+        ui->nav_items[ui->nav_cells[cell]++] = i;
+    }
+    for(uint32_t i = dim*dim; i > 0; --i) {
+        ui->nav_cells[i] = ui->nav_cells[i-1];
+    }
+    ui->nav_cells[0] = 0;
+}
+
+uint32_t _rf__ui_nav_cell(rf_UIState *ui, rf_UIFocusItem *item) {
+    uint32_t cx = (uint32_t)((item->x + item->w/2 - ui->nav_x) / ui->nav_cell_w),
+             cy = (uint32_t)((item->y + item->h/2 - ui->nav_y) / ui->nav_cell_h);
+    cx = cx < ui->nav_dim ? cx : ui->nav_dim - 1;
+    cy = cy < ui->nav_dim ? cy : ui->nav_dim - 1;
+    return cy * ui->nav_dim + cx;
+}
+
+long int _rf__ui_nav_nearest(rf_UIState *ui, long int from, int dir_x, int dir_y) {
+    rf_UIFocusItem *origin = ui->focus_items + from;
+    float ox = origin->x + origin->w/2,
+          oy = origin->y + origin->h/2;
+    int32_t dim = (int32_t)ui->nav_dim;
+    uint32_t origin_cell = _rf__ui_nav_cell(ui, origin);
+    int32_t ocx = (int32_t)(origin_cell % ui->nav_dim),
+            ocy = (int32_t)(origin_cell / ui->nav_dim);
+    float cell_size = ui->nav_cell_w < ui->nav_cell_h ? ui->nav_cell_w : ui->nav_cell_h;
+
+    long int best = -1;
+    float best_score = 1e30f;
+
+    for(int32_t ring = 0; ring < dim; ++ring) {
+        if(best >= 0 && (ring - 1) * cell_size > best_score) {
+            break;
+        }
+
+        for(int32_t cy = ocy - ring; cy <= ocy + ring; ++cy) {
+            if(cy < 0 || cy >= dim) {
+                continue;
+            }
+            for(int32_t cx = ocx - ring; cx <= ocx + ring; ++cx) {
+                if(cx < 0 || cx >= dim) {
+                    continue;
+                }
+                if(cy != ocy - ring && cy != ocy + ring && cx != ocx - ring && cx != ocx + ring) {
+                    continue;
+                }
+                if((cx - ocx) * dir_x < 0 || (cy - ocy) * dir_y < 0) {
+                    continue;
+                }
+
+                uint32_t cell = (uint32_t)(cy * dim + cx);
+                for(uint32_t i = ui->nav_cells[cell]; i < ui->nav_cells[cell+1]; ++i) {
+                    long int index = (long int)ui->nav_items[i];
+                    if(index == from) {
+                        continue;
+                    }
+
+                    rf_UIFocusItem *item = ui->focus_items + index;
+                    float dx = item->x + item->w/2 - ox,
+                          dy = item->y + item->h/2 - oy;
+                    float along = dx*dir_x + dy*dir_y,
+                          across = dx*dir_y + dy*dir_x;
+                    if(across < 0) {
+                        across = -across;
+                    }
+                    if(along <= 0) {
+                        continue;
+                    }
+
+                    float score = along + 2*across;
+                    if(score < best_score) {
+                        best_score = score;
+                        best = index;
+                    }
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+void rf_ui_panel_begin(rf_UIState *ui, rf_UIState *panel, rf_ui_id id) {
+    if(panel == ui) {
+        return;
+    }
+
+    rf_ui_begin(panel);
+    rf_ui_push_id(panel, id);
+
+    // everything a widget reads is copied, so building the panel never
+    // touches the parent
+    panel->hot = ui->hot;
+    panel->active = ui->active;
+    panel->panel_active = ui->active;
+    panel->scroll_hover = ui->scroll_hover;
+    panel->current_focus_id = ui->current_focus_id;
+    panel->current_focus_group = ui->current_focus_group;
+
+    panel->cursor_x = ui->cursor_x;
+    panel->cursor_y = ui->cursor_y;
+    panel->input_x = ui->input_x;
+    panel->input_y = ui->input_y;
+    panel->scroll_y = ui->scroll_y;
+    panel->char_input = ui->char_input;
+    for(int i = 0; i < RF_MAX_UI_CONTROL; ++i) {
+        panel->controls[i] = ui->controls[i];
+        panel->control_held[i] = ui->control_held[i];
+    }
+    panel->events = (rf_UIEvent *)_rf__ui_grow(panel->events, &panel->event_cap, sizeof(rf_UIEvent), ui->event_count);
+    for(uint32_t i = 0; i < ui->event_count; ++i) {
+        panel->events[i] = ui->events[i];
+    }
+    panel->event_count = ui->event_count;
+    panel->pointer_event_count = ui->pointer_event_count;
+    panel->key_event_count = ui->key_event_count;
+
+    // a panel with a measurer of its own keeps it, so panels on different
+    // threads don't have to share one
+    if(!panel->text_width_func) {
+        panel->text_width_func = ui->text_width_func;
+        panel->text_width_user = ui->text_width_user;
+    }
+    panel->line_height = ui->line_height;
+    panel->delta_time = ui->delta_time;
+    if(ui->draw_list && panel->draw_list) {
+        for(int i = 0; i < RF_MAX_UI_STYLE; ++i) {
+            for(int j = 0; j < 3; ++j) {
+                panel->draw_list->colors[i][j] = ui->draw_list->colors[i][j];
+            }
+        }
+    }
+
+    ui->panels = (rf_UIState **)_rf__ui_grow(ui->panels, &ui->panel_cap, sizeof(rf_UIState *), ui->panel_count + 1);
+    ui->panels[ui->panel_count++] = panel;
+}
+
+void _rf__ui_merge_draw_list(rf_UIDrawList *list, rf_UIDrawList *from) {
+    uint32_t clip_base = list->clip_count,
+             text_base = list->text_size,
+             command_base = list->command_count;
+
+    list->clips = (float *)_rf__ui_grow(list->clips, &list->clip_cap, 4 * sizeof(float), clip_base + from->clip_count);
+    for(uint32_t i = 0; i < 4 * from->clip_count; ++i) {
+        list->clips[4 * clip_base + i] = from->clips[i];
+    }
+    list->clip_count += from->clip_count;
+
+    list->text = (char *)_rf__ui_grow(list->text, &list->text_cap, 1, text_base + from->text_size);
+    for(uint32_t i = 0; i < from->text_size; ++i) {
+        list->text[text_base + i] = from->text[i];
+    }
+    list->text_size += from->text_size;
+
+    list->commands = (rf_UICommand *)_rf__ui_grow(list->commands, &list->command_cap, sizeof(rf_UICommand),
+                                                  command_base + from->command_count);
+    for(uint32_t i = 0; i < from->command_count; ++i) {
+        rf_UICommand *command = list->commands + command_base + i;
+        *command = from->commands[i];
+        command->clip += clip_base;
+        command->text_offset += text_base;
+    }
+    list->command_count += from->command_count;
+}
+
+void _rf__ui_end_windows(rf_UIState *ui);
+void _rf__ui_damage_windows(rf_UIState *ui);
+
+// folds every panel into the parent in the order they were begun, as if
+// they had been built after the parent's own widgets on one thread
+void _rf__ui_merge_panels(rf_UIState *ui) {
+    for(uint32_t p = 0; p < ui->panel_count; ++p) {
+        rf_UIState *panel = ui->panels[p];
+
+        if(panel->hit_id && (!ui->hit_id || panel->hit_layer >= ui->hit_layer)) {
+            ui->hit_id = panel->hit_id;
+            ui->hit_layer = panel->hit_layer;
+        }
+        if(panel->hit_scroll_id && (!ui->hit_scroll_id || panel->hit_scroll_layer >= ui->hit_scroll_layer)) {
+            ui->hit_scroll_id = panel->hit_scroll_id;
+            ui->hit_scroll_layer = panel->hit_scroll_layer;
+        }
+        if(panel->active != panel->panel_active) {
+            ui->active = panel->active;
+        }
+
+        ui->focus_items = (rf_UIFocusItem *)_rf__ui_grow(ui->focus_items, &ui->focus_item_cap, sizeof(rf_UIFocusItem),
+                                                         ui->focus_item_count + panel->focus_item_count);
+        for(uint32_t i = 0; i < panel->focus_item_count; ++i) {
+            ui->focus_items[ui->focus_item_count++] = panel->focus_items[i];
+        }
+
+        // controls a panel's widgets used up are used up for everyone
+        for(int i = 0; i < RF_MAX_UI_CONTROL; ++i) {
+            if(!panel->controls[i]) {
+                ui->controls[i] = 0;
+            }
+        }
+
+        _rf__ui_end_windows(panel);
+        if(ui->draw_list && panel->draw_list) {
+            _rf__ui_merge_draw_list(ui->draw_list, panel->draw_list);
+        }
+        if(ui->access_tree && panel->access_tree) {
+            _rf__ui_merge_access_tree(ui->access_tree, panel->access_tree);
+        }
+        _rf__ui_collect_states(panel);
+        _rf__ui_update_animations(panel);
+        if(panel->frame_requested) {
+            ui->frame_requested = 1;
+            panel->frame_requested = 0;
+        }
+
+        panel->event_count = 0;
+        panel->pointer_event_count = 0;
+        panel->key_event_count = 0;
+    }
+    ui->panel_count = 0;
+}
+
+void rf_ui_end(rf_UIState *ui) {
+    _rf__ui_merge_panels(ui);
+
+    int dir_x = (ui->controls[RF_UI_CONTROL_RIGHT_PRESS] != 0) - (ui->controls[RF_UI_CONTROL_LEFT_PRESS] != 0),
+        dir_y = (ui->controls[RF_UI_CONTROL_DOWN_PRESS] != 0) - (ui->controls[RF_UI_CONTROL_UP_PRESS] != 0);
+    if(dir_x && dir_y) {
+        dir_y = 0;
+    }
+
+    if(ui->current_focus_id < 0) {
+        if(ui->focus_item_count &&
+           (ui->controls[RF_UI_CONTROL_UP_PRESS] ||
+            ui->controls[RF_UI_CONTROL_LEFT_PRESS] ||
+            ui->controls[RF_UI_CONTROL_DOWN_PRESS] ||
+            ui->controls[RF_UI_CONTROL_RIGHT_PRESS] ||
+            ui->controls[RF_UI_CONTROL_NEXT_PRESS] ||
+            ui->controls[RF_UI_CONTROL_PREV_PRESS])) {
+            ui->current_focus_id = 0;
+        }
+    }
+    else {
+        if(ui->focus_item_count) {
+            int focus_update = 0;
+            if(ui->current_focus_id >= ui->focus_item_count) {
+                ui->current_focus_id = 0;
+            }
+            if(ui->controls[RF_UI_CONTROL_NEXT_PRESS]) {
+                if(++ui->current_focus_id >= ui->focus_item_count) {
+                    ui->current_focus_id = 0;
+                }
+                focus_update = 1;
+            }
+            if(ui->controls[RF_UI_CONTROL_PREV_PRESS]) {
+                if(--ui->current_focus_id < 0) {
+                    ui->current_focus_id = ui->focus_item_count-1;
+                }
+                focus_update = 1;
+            }
+            if(dir_x || dir_y) {
+                _rf__ui_build_nav_grid(ui);
+                long int nearest = _rf__ui_nav_nearest(ui, ui->current_focus_id, dir_x, dir_y);
+                if(nearest >= 0) {
+                    ui->current_focus_id = nearest;
+                }
+                focus_update = 1;
+            }
+
+            if(focus_update) {
+                ui->hot = ui->focus_items[ui->current_focus_id].id;
+            }
+        }
+        else {
+            ui->current_focus_id = -1;
+        }
+    }
+
+    _rf__ui_resolve_hits(ui);
+    _rf__ui_end_windows(ui);
+    _rf__ui_collect_states(ui);
+    _rf__ui_update_animations(ui);
+
+    if(ui->draw_list) {
+        _rf__ui_diff_draw_list(ui);
+        _rf__ui_damage_windows(ui);
+    }
+    if(ui->access_tree) {
+        _rf__ui_index_access_tree(ui->access_tree);
+    }
+    _rf__ui_update_idle(ui);
+
+    ui->event_count = 0;
+    ui->pointer_event_count = 0;
+    ui->key_event_count = 0;
+}
+
+void _rf__ui_add_focus(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h) {
+    if(ui->focusing) {
+        ui->focus_items = (rf_UIFocusItem *)_rf__ui_grow(ui->focus_items, &ui->focus_item_cap, sizeof(rf_UIFocusItem),
+                                                         ui->focus_item_count + 1);
+        rf_UIFocusItem *item = ui->focus_items + ui->focus_item_count++;
+        item->id = id;
+        item->x = x;
+        item->y = y;
+        item->w = w;
+        item->h = h;
+    }
+}
+
+void rf_ui_focus(rf_UIState *ui, long int group) {
+    ui->focusing = (ui->current_focus_group == group || !group);
+}
+
+void rf_ui_unfocus(rf_UIState *ui) {
+    ui->focusing = 0;
+}
+
+// click/activate handling shared by buttons and other clickable rows;
+// returns 1 on the frame the widget is clicked
+int _rf__ui_button_behavior(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h) {
+    int activated = 0;
+
+    if(ui->current_focus_id < 0) {
+        int hit = rf_ui_hit_rect(ui, id, x, y, w, h);
+        float px, py;
+        int down;
+        uint32_t i = 0;
+        while(_rf__ui_next_pointer(ui, &i, &px, &py, &down)) {
+            if(hit && _rf__ui_point_over(px, py, x, y, w, h)) {
+                if(ui->active == id && !down) {
+                    activated = 1;
+                }
+                if(down && !ui->active) {
+                    ui->active = id;
+                }
+            }
+            if(ui->active == id && !down) {
+                ui->active = 0;
+            }
+        }
+    }
+    else {
+        if(ui->hot == id) {
+            if(ui->controls[RF_UI_CONTROL_ACTIVATE]) {
+                activated = 1;
+            }
+        }
+    }
+
+    return activated;
+}
+
+int rf_button(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h) {
+    _rf__ui_add_focus(ui, id, x, y, w, h);
+    uint32_t node = _rf__ui_access(ui, id, RF_UI_ROLE_BUTTON, x, y, w, h, NULL);
+    if(_rf__ui_culled(ui, id, x, y, w, h)) {
+        return 0;
+    }
+
+    int activated = _rf__ui_button_behavior(ui, id, x, y, w, h);
+    _rf__ui_access_value(ui, node, (float)activated);
+    _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_BUTTON, x, y, w, h);
+
+    return activated;
+}
+
+uint32_t rf_ui_format_int(char *out, int64_t value) {
+    char digits[20];
+    uint32_t count = 0,
+             len = 0;
+    uint64_t magnitude = value < 0 ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while(magnitude);
+
+    if(value < 0) {
+        out[len++] = '-';
+    }
+    while(count) {
+        out[len++] = digits[--count];
+    }
+    out[len] = 0;
+    return len;
+}
+
+uint32_t rf_ui_format_float(char *out, double value, int decimals) {
+    if(value != value) {
+        out[0] = 'n'; out[1] = 'a'; out[2] = 'n'; out[3] = 0;
+        return 3;
+    }
+
+    uint32_t len = 0;
+    if(value < 0) {
+        out[len++] = '-';
+        value = -value;
+    }
+    if(value > 1.7976931348623157e308) {
+        out[len++] = 'i'; out[len++] = 'n'; out[len++] = 'f';
+        out[len] = 0;
+        return len;
+    }
+
+    decimals = decimals < 0 ? 0 : decimals > 9 ? 9 : decimals;
+    uint64_t scale = 1;
+    for(int i = 0; i < decimals; ++i) {
+        scale *= 10;
+    }
+
+    // too big to scale into an integer: print a mantissa and an exponent
+    int exponent = 0;
+    if(value * scale >= 1e18) {
+        while(value >= 10) {
+            value /= 10;
+            ++exponent;
+        }
+    }
+
+    uint64_t scaled = (uint64_t)(value * scale + 0.5);
+    if(exponent && scaled >= 10 * scale) {
+        scaled = (scaled + 5) / 10;
+        ++exponent;
+    }
+    len += rf_ui_format_int(out + len, (int64_t)(scaled / scale));
+    if(decimals) {
+        uint64_t fraction = scaled % scale;
+        out[len++] = '.';
+        for(uint64_t digit = scale / 10; digit; digit /= 10) {
+            out[len++] = (char)('0' + fraction / digit % 10);
+        }
+    }
+    if(exponent) {
+        out[len++] = 'e';
+        len += rf_ui_format_int(out + len, exponent);
+    }
+    out[len] = 0;
+    return len;
+}
+
+typedef union _rf__UIDoubleBits {
+    double d;
+    int32_t i[2];
+} _rf__UIDoubleBits;
+
+enum {
+    _RF_UI_VALUE_IDLE,
+    _RF_UI_VALUE_DRAG,
+    _RF_UI_VALUE_KEYS
+};
+
+void _rf__ui_value_anchor(rf_UIWidgetState *state, int mode, int modifier, double value, float px) {
+    _rf__UIDoubleBits start;
+    start.d = value;
+    state->i[0] = mode;
+    state->i[1] = modifier;
+    state->i[2] = start.i[0];
+    state->i[3] = start.i[1];
+    state->f[0] = px;
+    state->f[1] = 0;
+}
+
+double _rf__ui_value_start(rf_UIWidgetState *state) {
+    _rf__UIDoubleBits start;
+    start.i[0] = state->i[2];
+    start.i[1] = state->i[3];
+    return start.d;
+}
+
+// input handling shared by the value widgets. Drags (relative to where they
+// started, by per_pixel a pixel, or absolute across the widget if per_pixel
+// is 0) and held LEFT/RIGHT keys (key_step at first, speeding up the longer
+// they're held) always recompute the value from where the interaction
+// started, so it doesn't drift from adding up per-frame steps
+double _rf__ui_value_behavior(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h,
+                              double value, double per_pixel, double key_step, double min, double max) {
+    rf_UIWidgetState *state = ui->hot == id || ui->active == id ? rf_ui_get_state(ui, id) : NULL;
+    int fine = ui->controls[RF_UI_CONTROL_SELECT_HOLD] != 0;
+
+    if(ui->current_focus_id < 0) {
+        int hit = rf_ui_hit_rect(ui, id, x, y, w, h);
+        float px, py;
+        int down;
+        uint32_t i = 0;
+        while(_rf__ui_next_pointer(ui, &i, &px, &py, &down)) {
+            if(ui->active == id) {
+                if(!down) {
+                    ui->active = 0;
+                    state->i[0] = _RF_UI_VALUE_IDLE;
+                }
+                else if(per_pixel == 0) {
+                    value = min + (px - x) / w * (max - min);
+                }
+                else {
+                    // changing precision mid-drag starts over from here, so the value doesn't jump
+                    if(state->i[0] != _RF_UI_VALUE_DRAG || state->i[1] != fine) {
+                        _rf__ui_value_anchor(state, _RF_UI_VALUE_DRAG, fine, value, px);
+                    }
+                    value = _rf__ui_value_start(state) + (px - state->f[0]) * per_pixel * (fine ? RF_UI_DRAG_FINE : 1);
+                }
+            }
+            else if(hit && _rf__ui_point_over(px, py, x, y, w, h)) {
+                if(down && !ui->active) {
+                    ui->active = id;
+                    _rf__ui_value_anchor(state, _RF_UI_VALUE_DRAG, fine, value, px);
+                }
+            }
+        }
+    }
+    else if(ui->hot == id) {
+        ui->active = id;
+        int direction = (ui->controls[RF_UI_CONTROL_RIGHT_HOLD] != 0) - (ui->controls[RF_UI_CONTROL_LEFT_HOLD] != 0);
+        if(!direction) {
+            state->i[0] = _RF_UI_VALUE_IDLE;
+        }
+        else {
+            if(state->i[0] != _RF_UI_VALUE_KEYS || state->i[1] != direction) {
+                _rf__ui_value_anchor(state, _RF_UI_VALUE_KEYS, direction, value, 0);
+            }
+            else {
+                state->f[1] += ui->delta_time;
+            }
+            float t = state->f[1];
+            value = _rf__ui_value_start(state) + direction * key_step * (1 + RF_UI_KEY_REPEAT_RATE * (t + t*t));
+            rf_ui_request_frame(ui);
+        }
+    }
+
+    if(min < max) {
+        value = value < min ? min : value > max ? max : value;
+    }
+    return value;
+}
+
+void _rf__ui_draw_value(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, const char *text, uint32_t len) {
+    float text_w = _rf__ui_text_width(ui, text, len);
+    // a clip change starts a new batch, so only clip values that don't fit
+    int clip = text_w > w || ui->line_height > h;
+    if(clip) {
+        rf_ui_push_clip(ui, x, y, w, h);
+    }
+    _rf__ui_draw_widget_text(ui, id, RF_UI_STYLE_TEXT, x + (w - text_w) / 2, y + (h - ui->line_height) / 2, text, len, 0);
+    if(clip) {
+        rf_ui_pop_clip(ui);
+    }
+}
+
+float rf_slider_range(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float value,
+                      float min, float max, int decimals) {
+    _rf__ui_add_focus(ui, id, x, y, w, h);
+    uint32_t node = _rf__ui_access(ui, id, RF_UI_ROLE_SLIDER, x, y, w, h, NULL);
+    _rf__ui_access_value(ui, node, value);
+    if(_rf__ui_culled(ui, id, x, y, w, h)) {
+        return value;
+    }
+
+    value = (float)_rf__ui_value_behavior(ui, id, x, y, w, h, value, 0, (max - min) * 0.01, min, max);
+
+    _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_SLIDER_TRACK, x, y, w, h);
+    if(ui->draw_list) {
+        char text[RF_UI_FORMAT_SIZE];
+        _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_SLIDER_FILL, x, y, max > min ? w * (value - min) / (max - min) : 0, h);
+        _rf__ui_draw_value(ui, id, x, y, w, h, text, rf_ui_format_float(text, value, decimals));
+    }
+    _rf__ui_access_value(ui, node, value);
+    return value;
+}
+
+float rf_drag_float(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float value,
+                    float speed, float min, float max, int decimals) {
+    _rf__ui_add_focus(ui, id, x, y, w, h);
+    uint32_t node = _rf__ui_access(ui, id, RF_UI_ROLE_DRAG, x, y, w, h, NULL);
+    _rf__ui_access_value(ui, node, value);
+    if(_rf__ui_culled(ui, id, x, y, w, h)) {
+        return value;
+    }
+
+    value = (float)_rf__ui_value_behavior(ui, id, x, y, w, h, value, speed, speed, min, max);
+
+    _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_SLIDER_TRACK, x, y, w, h);
+    if(ui->draw_list) {
+        char text[RF_UI_FORMAT_SIZE];
+        _rf__ui_draw_value(ui, id, x, y, w, h, text, rf_ui_format_float(text, value, decimals));
+    }
+    _rf__ui_access_value(ui, node, value);
+    return value;
+}
+
+int rf_drag_int(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, int value,
+                float speed, int min, int max) {
+    _rf__ui_add_focus(ui, id, x, y, w, h);
+    uint32_t node = _rf__ui_access(ui, id, RF_UI_ROLE_DRAG, x, y, w, h, NULL);
+    _rf__ui_access_value(ui, node, (float)value);
+    if(_rf__ui_culled(ui, id, x, y, w, h)) {
+        return value;
+    }
+
+    double result = _rf__ui_value_behavior(ui, id, x, y, w, h, value, speed, speed > 1 ? speed : 1, min, max);
+    value = (int)(result < 0 ? result - 0.5 : result + 0.5);
+
+    _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_SLIDER_TRACK, x, y, w, h);
+    if(ui->draw_list) {
+        char text[RF_UI_FORMAT_SIZE];
+        _rf__ui_draw_value(ui, id, x, y, w, h, text, rf_ui_format_int(text, value));
+    }
+    _rf__ui_access_value(ui, node, (float)value);
+    return value;
+}
+
+int rf_drag_float_n(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float *values, uint32_t count,
+                    float speed, float min, float max, int decimals) {
+    int changed = 0;
+    float cell_w = count ? (w - ui->layout_spacing * (count - 1)) / count : 0;
+    _rf__ui_access_push(ui, _rf__ui_access(ui, id, RF_UI_ROLE_GROUP, x, y, w, h, NULL));
+    for(uint32_t i = 0; i < count; ++i) {
+        float value = rf_drag_float(ui, rf_ui_hash(&i, sizeof(i), id), x + i * (cell_w + ui->layout_spacing), y,
+                                    cell_w, h, values[i], speed, min, max, decimals);
+        if(value != values[i]) {
+            values[i] = value;
+            changed = 1;
+        }
+    }
+    _rf__ui_access_pop(ui);
+    return changed;
+}
+
+float rf_slider(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float value) {
+    _rf__ui_add_focus(ui, id, x, y, w, h);
+    uint32_t node = _rf__ui_access(ui, id, RF_UI_ROLE_SLIDER, x, y, w, h, NULL);
+    _rf__ui_access_value(ui, node, value);
+    if(_rf__ui_culled(ui, id, x, y, w, h)) {
+        return value;
+    }
+
+    value = (float)_rf__ui_value_behavior(ui, id, x, y, w, h, value, 0, 0.01, 0, 1);
+
+    _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_SLIDER_TRACK, x, y, w, h);
+    _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_SLIDER_FILL, x, y, w*value, h);
+
+    _rf__ui_access_value(ui, node, value);
+    return value;
+}
+
+void _rf__ui_move_bytes(char *dest, const char *src, uint32_t n) {
+    if(dest < src) {
+        for(uint32_t i = 0; i < n; ++i) {
+            dest[i] = src[i];
+        }
+    }
+    else if(dest > src) {
+        for(uint32_t i = n; i > 0; --i) {
+            dest[i-1] = src[i-1];
+        }
+    }
+}
+
+rf_UITextBuffer rf_ui_text_init(void) {
+    rf_UITextBuffer buf;
+    buf.data = NULL;
+    buf.gap_start = buf.gap_end = buf.cap = 0;
+    buf.cursor = buf.anchor = 0;
+    buf.column = _RF_UI_TEXT_NO_COLUMN;
+    buf.line_starts = NULL;
+    buf.line_count = buf.line_cap = 0;
+    buf.edits = NULL;
+    buf.edit_count = buf.edit_pos = buf.edit_cap = 0;
+    buf.edit_text = NULL;
+    buf.edit_text_size = buf.edit_text_cap = 0;
+    buf.group = 0;
+    buf.typing = 0;
+    buf.version = 0;
+    return buf;
+}
+
+void rf_ui_text_clean_up(rf_UITextBuffer *buf) {
+    RF_UI_FREE(buf->data);
+    RF_UI_FREE(buf->line_starts);
+    RF_UI_FREE(buf->edits);
+    RF_UI_FREE(buf->edit_text);
+    *buf = rf_ui_text_init();
+}
+
+uint32_t rf_ui_text_length(const rf_UITextBuffer *buf) {
+    return buf->cap - (buf->gap_end - buf->gap_start);
+}
+
+char rf_ui_text_at(const rf_UITextBuffer *buf, uint32_t pos) {
+    return pos < buf->gap_start ? buf->data[pos] : buf->data[pos + buf->gap_end - buf->gap_start];
+}
+
+uint32_t rf_ui_text_copy(const rf_UITextBuffer *buf, uint32_t start, uint32_t end, char *out) {
+    for(uint32_t i = start; i < end; ++i) {
+        out[i - start] = rf_ui_text_at(buf, i);
+    }
+    return end - start;
+}
+
+void _rf__ui_text_move_gap(rf_UITextBuffer *buf, uint32_t pos) {
+    uint32_t gap = buf->gap_end - buf->gap_start;
+    if(pos < buf->gap_start) {
+        _rf__ui_move_bytes(buf->data + pos + gap, buf->data + pos, buf->gap_start - pos);
+    }
+    else if(pos > buf->gap_start) {
+        _rf__ui_move_bytes(buf->data + buf->gap_start, buf->data + buf->gap_end, pos - buf->gap_start);
+    }
+    buf->gap_start = pos;
+    buf->gap_end = pos + gap;
+}
+
+void _rf__ui_text_reserve(rf_UITextBuffer *buf, uint32_t n) {
+    if(buf->gap_end - buf->gap_start < n) {
+        uint32_t len = rf_ui_text_length(buf),
+                 tail = buf->cap - buf->gap_end,
+                 cap = buf->cap ? buf->cap * 2 : _RF_UI_ARRAY_START_CAP;
+        while(cap < len + n) {
+            cap *= 2;
+        }
+        buf->data = (char *)RF_UI_REALLOC(buf->data, cap);
+        _rf__ui_move_bytes(buf->data + cap - tail, buf->data + buf->gap_end, tail);
+        buf->gap_end = cap - tail;
+        buf->cap = cap;
+    }
+}
+
+// index of the first line that starts after pos
+uint32_t _rf__ui_text_line_after(const rf_UITextBuffer *buf, uint32_t pos) {
+    uint32_t lo = 0, hi = buf->line_count;
+    while(lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if(buf->line_starts[mid] > pos) {
+            hi = mid;
+        }
+        else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+void _rf__ui_text_raw_insert(rf_UITextBuffer *buf, uint32_t pos, const char *text, uint32_t len) {
+    if(!buf->line_count) {
+        buf->line_starts = (uint32_t *)_rf__ui_grow(buf->line_starts, &buf->line_cap, sizeof(uint32_t), 1);
+        buf->line_starts[0] = 0;
+        buf->line_count = 1;
+    }
+
+    _rf__ui_text_reserve(buf, len);
+    _rf__ui_text_move_gap(buf, pos);
+    uint32_t newlines = 0;
+    for(uint32_t i = 0; i < len; ++i) {
+        buf->data[buf->gap_start + i] = text[i];
+        newlines += text[i] == '\n';
+    }
+    buf->gap_start += len;
+
+    uint32_t first = _rf__ui_text_line_after(buf, pos);
+    for(uint32_t i = first; i < buf->line_count; ++i) {
+        buf->line_starts[i] += len;
+    }
+    if(newlines) {
+        buf->line_starts = (uint32_t *)_rf__ui_grow(buf->line_starts, &buf->line_cap, sizeof(uint32_t),
+                                                    buf->line_count + newlines);
+        for(uint32_t i = buf->line_count; i > first; --i) {
+            buf->line_starts[i-1 + newlines] = buf->line_starts[i-1];
+        }
+        for(uint32_t i = 0; i < len; ++i) {
+            if(text[i] == '\n') {
+                buf->line_starts[first++] = pos + i + 1;
+            }
+        }
+        buf->line_count += newlines;
+    }
+    ++buf->version;
+}
+
+void _rf__ui_text_raw_delete(rf_UITextBuffer *buf, uint32_t pos, uint32_t len) {
+    uint32_t first = _rf__ui_text_line_after(buf, pos),
+             last = _rf__ui_text_line_after(buf, pos + len);
+
+    _rf__ui_text_move_gap(buf, pos);
+    buf->gap_end += len;
+
+    for(uint32_t i = last; i < buf->line_count; ++i) {
+        buf->line_starts[first + i - last] = buf->line_starts[i] - len;
+    }
+    buf->line_count -= last - first;
+    ++buf->version;
+}
+
+void _rf__ui_text_record(rf_UITextBuffer *buf, int insert, uint32_t pos, uint32_t len, const char *text) {
+    if(buf->edit_pos < buf->edit_count) {
+        buf->edit_text_size = buf->edits[buf->edit_pos].text_offset;
+        buf->edit_count = buf->edit_pos;
+    }
+
+    buf->edit_text = (char *)_rf__ui_grow(buf->edit_text, &buf->edit_text_cap, 1, buf->edit_text_size + len);
+    if(text) {
+        for(uint32_t i = 0; i < len; ++i) {
+            buf->edit_text[buf->edit_text_size + i] = text[i];
+        }
+    }
+    else {
+        rf_ui_text_copy(buf, pos, pos + len, buf->edit_text + buf->edit_text_size);
+    }
+
+    rf_UITextEdit *last = buf->edit_count ? buf->edits + buf->edit_count - 1 : NULL;
+    if(insert && last && last->insert && last->group == buf->group && last->pos + last->len == pos &&
+       last->text_offset + last->len == buf->edit_text_size) {
+        last->len += len;
+    }
+    else {
+        buf->edits = (rf_UITextEdit *)_rf__ui_grow(buf->edits, &buf->edit_cap, sizeof(rf_UITextEdit), buf->edit_count + 1);
+        rf_UITextEdit *edit = buf->edits + buf->edit_count++;
+        edit->pos = pos;
+        edit->len = len;
+        edit->text_offset = buf->edit_text_size;
+        edit->cursor = buf->cursor;
+        edit->anchor = buf->anchor;
+        edit->group = buf->group;
+        edit->insert = (uint8_t)insert;
+    }
+    buf->edit_text_size += len;
+    buf->edit_pos = buf->edit_count;
+}
+
+void _rf__ui_text_delete_range(rf_UITextBuffer *buf, uint32_t start, uint32_t end) {
+    if(end > start) {
+        _rf__ui_text_record(buf, 0, start, end - start, NULL);
+        _rf__ui_text_raw_delete(buf, start, end - start);
+    }
+    buf->cursor = buf->anchor = start;
+    buf->column = _RF_UI_TEXT_NO_COLUMN;
+}
+
+void rf_ui_text_set(rf_UITextBuffer *buf, const char *text, uint32_t len) {
+    buf->gap_start = 0;
+    buf->gap_end = buf->cap;
+    buf->line_count = 0;
+    _rf__ui_text_raw_insert(buf, 0, text, len);
+    buf->cursor = buf->anchor = 0;
+    buf->column = _RF_UI_TEXT_NO_COLUMN;
+    buf->edit_count = buf->edit_pos = 0;
+    buf->edit_text_size = 0;
+    buf->typing = 0;
+}
+
+void rf_ui_text_insert(rf_UITextBuffer *buf, const char *text, uint32_t len) {
+    int typing = len <= 4;
+    for(uint32_t i = 0; i < len; ++i) {
+        typing &= text[i] != '\n';
+    }
+    if(!(typing && buf->typing && buf->cursor == buf->anchor)) {
+        ++buf->group;
+    }
+
+    uint32_t start = buf->cursor < buf->anchor ? buf->cursor : buf->anchor,
+             end = buf->cursor < buf->anchor ? buf->anchor : buf->cursor;
+    _rf__ui_text_delete_range(buf, start, end);
+    if(len) {
+        _rf__ui_text_record(buf, 1, start, len, text);
+        _rf__ui_text_raw_insert(buf, start, text, len);
+    }
+    buf->cursor = buf->anchor = start + len;
+    buf->typing = typing;
+}
+
+int _rf__ui_text_class(char c) {
+    if(c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        return 0;
+    }
+    if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || (unsigned char)c >= 0x80) {
+        return 1;
+    }
+    return 2;
+}
+
+uint32_t rf_ui_text_line_count(const rf_UITextBuffer *buf) {
+    return buf->line_count ? buf->line_count : 1;
+}
+
+uint32_t rf_ui_text_line_of(const rf_UITextBuffer *buf, uint32_t pos) {
+    uint32_t line = _rf__ui_text_line_after(buf, pos);
+    return line ? line - 1 : 0;
+}
+
+uint32_t rf_ui_text_line_start(const rf_UITextBuffer *buf, uint32_t line) {
+    return line < buf->line_count ? buf->line_starts[line] : 0;
+}
+
+uint32_t rf_ui_text_line_end(const rf_UITextBuffer *buf, uint32_t line) {
+    return line + 1 < buf->line_count ? buf->line_starts[line + 1] - 1 : rf_ui_text_length(buf);
+}
+
+uint32_t _rf__ui_text_column(const rf_UITextBuffer *buf, uint32_t pos) {
+    uint32_t column = 0;
+    for(uint32_t i = rf_ui_text_line_start(buf, rf_ui_text_line_of(buf, pos)); i < pos; ++i) {
+        column += ((unsigned char)rf_ui_text_at(buf, i) & 0xC0) != 0x80;
+    }
+    return column;
+}
+
+uint32_t _rf__ui_text_at_column(const rf_UITextBuffer *buf, uint32_t line, uint32_t column) {
+    uint32_t pos = rf_ui_text_line_start(buf, line),
+             end = rf_ui_text_line_end(buf, line);
+    while(pos < end) {
+        if(((unsigned char)rf_ui_text_at(buf, pos) & 0xC0) != 0x80 && !column--) {
+            break;
+        }
+        ++pos;
+    }
+    return pos;
+}
+
+uint32_t _rf__ui_text_target(const rf_UITextBuffer *buf, uint32_t pos, int motion, uint32_t column) {
+    uint32_t len = rf_ui_text_length(buf);
+    switch(motion) {
+        case RF_UI_TEXT_LEFT: {
+            if(pos > 0) {
+                do {
+                    --pos;
+                } while(pos > 0 && ((unsigned char)rf_ui_text_at(buf, pos) & 0xC0) == 0x80);
+            }
+            break;
+        }
+        case RF_UI_TEXT_RIGHT: {
+            if(pos < len) {
+                ++pos;
+            }
+            while(pos < len && ((unsigned char)rf_ui_text_at(buf, pos) & 0xC0) == 0x80) {
+                ++pos;
+            }
+            break;
+        }
+        case RF_UI_TEXT_WORD_LEFT: {
+            while(pos > 0 && !_rf__ui_text_class(rf_ui_text_at(buf, pos-1))) {
+                --pos;
+            }
+            if(pos > 0) {
+                int word_class = _rf__ui_text_class(rf_ui_text_at(buf, pos-1));
+                while(pos > 0 && _rf__ui_text_class(rf_ui_text_at(buf, pos-1)) == word_class) {
+                    --pos;
+                }
+            }
+            break;
+        }
+        case RF_UI_TEXT_WORD_RIGHT: {
+            if(pos < len) {
+                int word_class = _rf__ui_text_class(rf_ui_text_at(buf, pos));
+                while(pos < len && word_class && _rf__ui_text_class(rf_ui_text_at(buf, pos)) == word_class) {
+                    ++pos;
+                }
+            }
+            while(pos < len && !_rf__ui_text_class(rf_ui_text_at(buf, pos))) {
+                ++pos;
+            }
+            break;
+        }
+        case RF_UI_TEXT_UP:
+        case RF_UI_TEXT_DOWN: {
+            uint32_t line = rf_ui_text_line_of(buf, pos);
+            if(motion == RF_UI_TEXT_UP) {
+                if(!line) {
+                    return 0;
+                }
+                --line;
+            }
+            else {
+                if(line + 1 >= rf_ui_text_line_count(buf)) {
+                    return len;
+                }
+                ++line;
+            }
+            pos = _rf__ui_text_at_column(buf, line, column);
+            break;
+        }
+        case RF_UI_TEXT_LINE_START: {
+            pos = rf_ui_text_line_start(buf, rf_ui_text_line_of(buf, pos));
+            break;
+        }
+        case RF_UI_TEXT_LINE_END: {
+            pos = rf_ui_text_line_end(buf, rf_ui_text_line_of(buf, pos));
+            break;
+        }
+        case RF_UI_TEXT_START: {
+            pos = 0;
+            break;
+        }
+        case RF_UI_TEXT_END: {
+            pos = len;
+            break;
+        }
+        default: break;
+    }
+    return pos;
+}
+
+void rf_ui_text_move(rf_UITextBuffer *buf, int motion, int select) {
+    int vertical = motion == RF_UI_TEXT_UP || motion == RF_UI_TEXT_DOWN;
+    if(!vertical || buf->column == _RF_UI_TEXT_NO_COLUMN) {
+        buf->column = vertical ? _rf__ui_text_column(buf, buf->cursor) : _RF_UI_TEXT_NO_COLUMN;
+    }
+
+    if(!select && buf->cursor != buf->anchor && (motion == RF_UI_TEXT_LEFT || motion == RF_UI_TEXT_RIGHT)) {
+        int left = motion == RF_UI_TEXT_LEFT;
+        buf->cursor = (buf->cursor < buf->anchor) == left ? buf->cursor : buf->anchor;
+    }
+    else {
+        buf->cursor = _rf__ui_text_target(buf, buf->cursor, motion, buf->column);
+    }
+    if(!select) {
+        buf->anchor = buf->cursor;
+    }
+    buf->typing = 0;
+}
+
+void rf_ui_text_select(rf_UITextBuffer *buf, uint32_t anchor, uint32_t cursor) {
+    uint32_t len = rf_ui_text_length(buf);
+    buf->anchor = anchor < len ? anchor : len;
+    buf->cursor = cursor < len ? cursor : len;
+    buf->column = _RF_UI_TEXT_NO_COLUMN;
+    buf->typing = 0;
+}
+
+void rf_ui_text_delete(rf_UITextBuffer *buf, int motion) {
+    uint32_t other = buf->cursor == buf->anchor ? _rf__ui_text_target(buf, buf->cursor, motion, 0) : buf->anchor;
+    ++buf->group;
+    buf->typing = 0;
+    _rf__ui_text_delete_range(buf, buf->cursor < other ? buf->cursor : other,
+                              buf->cursor < other ? other : buf->cursor);
+}
+
+void rf_ui_text_undo(rf_UITextBuffer *buf) {
+    if(buf->edit_pos) {
+        uint32_t group = buf->edits[buf->edit_pos-1].group;
+        while(buf->edit_pos && buf->edits[buf->edit_pos-1].group == group) {
+            rf_UITextEdit *edit = buf->edits + --buf->edit_pos;
+            if(edit->insert) {
+                _rf__ui_text_raw_delete(buf, edit->pos, edit->len);
+            }
+            else {
+                _rf__ui_text_raw_insert(buf, edit->pos, buf->edit_text + edit->text_offset, edit->len);
+            }
+            buf->cursor = edit->cursor;
+            buf->anchor = edit->anchor;
+        }
+    }
+    buf->column = _RF_UI_TEXT_NO_COLUMN;
+    buf->typing = 0;
+}
+
+void rf_ui_text_redo(rf_UITextBuffer *buf) {
+    if(buf->edit_pos < buf->edit_count) {
+        uint32_t group = buf->edits[buf->edit_pos].group;
+        while(buf->edit_pos < buf->edit_count && buf->edits[buf->edit_pos].group == group) {
+            rf_UITextEdit *edit = buf->edits + buf->edit_pos++;
+            if(edit->insert) {
+                _rf__ui_text_raw_insert(buf, edit->pos, buf->edit_text + edit->text_offset, edit->len);
+                buf->cursor = edit->pos + edit->len;
+            }
+            else {
+                _rf__ui_text_raw_delete(buf, edit->pos, edit->len);
+                buf->cursor = edit->pos;
+            }
+        }
+        buf->anchor = buf->cursor;
+    }
+    buf->column = _RF_UI_TEXT_NO_COLUMN;
+    buf->typing = 0;
+}
+
+const char *rf_ui_text_span(rf_UITextBuffer *buf, uint32_t start, uint32_t end) {
+    if(!buf->data) {
+        return "";
+    }
+    if(start < buf->gap_start && end > buf->gap_start) {
+        _rf__ui_text_move_gap(buf, buf->gap_start - start < end - buf->gap_start ? start : end);
+    }
+    return end <= buf->gap_start ? buf->data + start : buf->data + start + buf->gap_end - buf->gap_start;
+}
+
+float _rf__ui_text_width(rf_UIState *ui, const char *text, uint32_t len) {
+    if(ui->text_width_func) {
+        return ui->text_width_func(ui->text_width_user, text, len);
+    }
+    uint32_t codepoints = 0;
+    for(uint32_t i = 0; i < len; ++i) {
+        codepoints += ((unsigned char)text[i] & 0xC0) != 0x80;
+    }
+    return codepoints * RF_UI_CHAR_WIDTH;
+}
+
+// position on a line closest to x (relative to the start of the line)
+uint32_t _rf__ui_text_pos_at_x(rf_UIState *ui, rf_UITextBuffer *buf, uint32_t line, float x) {
+    uint32_t start = rf_ui_text_line_start(buf, line),
+             end = rf_ui_text_line_end(buf, line);
+    const char *text = rf_ui_text_span(buf, start, end);
+    float left = 0;
+    uint32_t i = 0;
+    while(start + i < end) {
+        uint32_t codepoint,
+                 size = _rf__ui_utf8_decode(text + i, end - start - i, &codepoint);
+        float advance = _rf__ui_text_width(ui, text + i, size);
+        if(x < left + advance/2) {
+            break;
+        }
+        left += advance;
+        i += size;
+    }
+    return start + i;
+}
+
+float _rf__ui_text_x_of(rf_UIState *ui, rf_UITextBuffer *buf, uint32_t pos) {
+    uint32_t start = rf_ui_text_line_start(buf, rf_ui_text_line_of(buf, pos));
+    return _rf__ui_text_width(ui, rf_ui_text_span(buf, start, pos), pos - start);
+}
+
+// the key/text input for this frame, in order: the event queue if there is one,
+// otherwise events made up from the per-frame fields
+rf_UIEvent *_rf__ui_key_events(rf_UIState *ui, rf_UIEvent *scratch, uint32_t *count) {
+    if(ui->key_event_count) {
+        *count = ui->event_count;
+        return ui->events;
+    }
+
+    static const uint8_t keys[] = {
+        RF_UI_CONTROL_UP_PRESS, RF_UI_CONTROL_LEFT_PRESS, RF_UI_CONTROL_DOWN_PRESS, RF_UI_CONTROL_RIGHT_PRESS,
+        RF_UI_CONTROL_ACTIVATE, RF_UI_CONTROL_BACKSPACE, RF_UI_CONTROL_DELETE, RF_UI_CONTROL_HOME,
+        RF_UI_CONTROL_END, RF_UI_CONTROL_SELECT_ALL, RF_UI_CONTROL_UNDO, RF_UI_CONTROL_REDO
+    };
+    uint8_t modifiers = (ui->controls[RF_UI_CONTROL_SELECT_HOLD] != 0) |
+                        (ui->controls[RF_UI_CONTROL_WORD_HOLD] != 0) << 1;
+    *count = 0;
+    if(ui->char_input) {
+        rf_UIEvent *event = scratch + (*count)++;
+        event->type = RF_UI_EVENT_TEXT;
+        event->codepoint = (unsigned char)ui->char_input;
+        event->modifiers = modifiers;
+    }
+    for(uint32_t i = 0; i < sizeof(keys); ++i) {
+        if(ui->controls[keys[i]]) {
+            rf_UIEvent *event = scratch + (*count)++;
+            event->type = RF_UI_EVENT_CONTROL;
+            event->control = keys[i];
+            event->down = 1;
+            event->modifiers = modifiers;
+        }
+    }
+    return scratch;
+}
+
+// applies one event to a text buffer (keeping it at most limit bytes long),
+// returns 1 if the text changed
+int _rf__ui_text_key(rf_UITextBuffer *buf, rf_UIEvent *event, int multiline, uint32_t limit) {
+    int select = event->modifiers & 1,
+        word = event->modifiers & 2;
+    uint32_t version = buf->version;
+
+    if(event->type == RF_UI_EVENT_TEXT || (multiline && event->type == RF_UI_EVENT_CONTROL &&
+                                           event->control == RF_UI_CONTROL_ACTIVATE && event->down)) {
+        char utf8[4];
+        uint32_t len = event->type == RF_UI_EVENT_TEXT ? _rf__ui_utf8_encode(event->codepoint, utf8) : 1;
+        if(event->type != RF_UI_EVENT_TEXT) {
+            utf8[0] = '\n';
+        }
+        else if(event->codepoint < 32 || event->codepoint == 127) {
+            len = 0;
+        }
+        uint32_t selected = buf->cursor < buf->anchor ? buf->anchor - buf->cursor : buf->cursor - buf->anchor;
+        if(len && rf_ui_text_length(buf) - selected + len <= limit) {
+            rf_ui_text_insert(buf, utf8, len);
+        }
+    }
+    else if(event->type == RF_UI_EVENT_CONTROL && event->down) {
+        switch(event->control) {
+            case RF_UI_CONTROL_BACKSPACE: rf_ui_text_delete(buf, word ? RF_UI_TEXT_WORD_LEFT : RF_UI_TEXT_LEFT); break;
+            case RF_UI_CONTROL_DELETE: rf_ui_text_delete(buf, word ? RF_UI_TEXT_WORD_RIGHT : RF_UI_TEXT_RIGHT); break;
+            case RF_UI_CONTROL_LEFT_PRESS: rf_ui_text_move(buf, word ? RF_UI_TEXT_WORD_LEFT : RF_UI_TEXT_LEFT, select); break;
+            case RF_UI_CONTROL_RIGHT_PRESS: rf_ui_text_move(buf, word ? RF_UI_TEXT_WORD_RIGHT : RF_UI_TEXT_RIGHT, select); break;
+            case RF_UI_CONTROL_UP_PRESS: if(multiline) rf_ui_text_move(buf, RF_UI_TEXT_UP, select); break;
+            case RF_UI_CONTROL_DOWN_PRESS: if(multiline) rf_ui_text_move(buf, RF_UI_TEXT_DOWN, select); break;
+            case RF_UI_CONTROL_HOME: rf_ui_text_move(buf, word ? RF_UI_TEXT_START : RF_UI_TEXT_LINE_START, select); break;
+            case RF_UI_CONTROL_END: rf_ui_text_move(buf, word ? RF_UI_TEXT_END : RF_UI_TEXT_LINE_END, select); break;
+            case RF_UI_CONTROL_SELECT_ALL: rf_ui_text_select(buf, 0, rf_ui_text_length(buf)); break;
+            case RF_UI_CONTROL_UNDO: rf_ui_text_undo(buf); break;
+            case RF_UI_CONTROL_REDO: rf_ui_text_redo(buf); break;
+            default: break;
+        }
+    }
+    return buf->version != version;
+}
+
+// handles the mouse for a text widget: clicking activates it and places the
+// cursor, dragging selects. *line_out/*x_out get where the cursor should go
+// (relative to the text's origin), returns 0 if it shouldn't move
+int _rf__ui_text_mouse(rf_UIState *ui, rf_ui_id id, rf_UIWidgetState *state, float x, float y, float w, float h,
+                       float origin_x, float origin_y, float *x_out, float *y_out, int *extend) {
+    int hit = rf_ui_hit_rect(ui, id, x, y, w, h),
+        moved = 0;
+    float px, py;
+    int down;
+    uint32_t i = 0;
+    while(_rf__ui_next_pointer(ui, &i, &px, &py, &down)) {
+        if(down) {
+            if(state->i[0] && ui->active == id) {
+                *extend = 1;
+            }
+            else if(hit && _rf__ui_point_over(px, py, x, y, w, h)) {
+                *extend = ui->active == id && ui->controls[RF_UI_CONTROL_SELECT_HOLD];
+                ui->active = id;
+                state->i[0] = 1;
+            }
+            else {
+                if(ui->active == id) {
+                    ui->active = 0;
+                }
+                state->i[0] = 0;
+                continue;
+            }
+            *x_out = px - origin_x;
+            *y_out = py - origin_y;
+            moved = 1;
+        }
+        else {
+            state->i[0] = 0;
+        }
+    }
+    return moved;
+}
+
+void _rf__ui_text_draw_line(rf_UIState *ui, rf_ui_id id, rf_UITextBuffer *buf, uint32_t line, float x, float y, float line_h) {
+    uint32_t start = rf_ui_text_line_start(buf, line),
+             end = rf_ui_text_line_end(buf, line),
+             sel_start = buf->cursor < buf->anchor ? buf->cursor : buf->anchor,
+             sel_end = buf->cursor < buf->anchor ? buf->anchor : buf->cursor;
+    int active = ui->active == id;
+
+    if(active && sel_start < sel_end && sel_start <= end && sel_end > start) {
+        uint32_t a = sel_start > start ? sel_start : start,
+                 b = sel_end < end ? sel_end : end;
+        float left = _rf__ui_text_width(ui, rf_ui_text_span(buf, start, a), a - start),
+              right = _rf__ui_text_width(ui, rf_ui_text_span(buf, start, b), b - start);
+        if(sel_end > end) {
+            right += RF_UI_CHAR_WIDTH;
+        }
+        _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_TEXT_SELECTION, x + left, y, right - left, line_h);
+    }
+
+    _rf__ui_draw_widget_text(ui, id, RF_UI_STYLE_TEXT, x, y, rf_ui_text_span(buf, start, end), end - start, 0);
+
+    if(active && buf->cursor >= start && buf->cursor <= end) {
+        float caret = _rf__ui_text_width(ui, rf_ui_text_span(buf, start, buf->cursor), buf->cursor - start);
+        _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_TEXT_CARET, x + caret, y, 1, line_h);
+    }
+}
+
+// keeps position `at` within [0, size) of a view scrolled by `scroll`
+float _rf__ui_scroll_to(float scroll, float at, float extent, float size) {
+    if(at + extent > scroll + size) {
+        scroll = at + extent - size;
+    }
+    if(at < scroll) {
+        scroll = at;
+    }
+    return scroll;
+}
+
+char *rf_line_edit(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, char *text, unsigned int max_chars) {
+    rf_UIWidgetState *state = rf_ui_get_state(ui, id);
+    rf_UITextBuffer *buf = &ui->edit_buffer;
+    float scroll = state->f[0],
+          click_x = 0, click_y = 0;
+    int click = 0, extend = 0;
+
+    _rf__ui_add_focus(ui, id, x, y, w, h);
+    uint32_t node = _rf__ui_access(ui, id, RF_UI_ROLE_LINE_EDIT, x, y, w, h, NULL);
+    if(_rf__ui_culled(ui, id, x, y, w, h)) {
+        _rf__ui_access_text(ui, node, text);
+        return text;
+    }
+
+    if(ui->current_focus_id < 0) {
+        click = _rf__ui_text_mouse(ui, id, state, x, y, w, h, x - scroll, y, &click_x, &click_y, &extend);
+    }
+    else {
+        if(ui->hot == id) {
+            ui->active = id;
+        }
+    }
+
+    if(ui->active == id) {
+        // the text is edited in ui->edit_buffer while the line edit is active,
+        // and copied back out whenever it changes
+        uint32_t len = rf_ui_text_length(buf), i = 0;
+        if(ui->edit_id == id) {
+            while(i < len && text[i] == rf_ui_text_at(buf, i)) {
+                ++i;
             }
         }
+        if(ui->edit_id != id || i != len || text[i]) {
+            rf_ui_text_set(buf, text, _rf__ui_strlen(text));
+            rf_ui_text_select(buf, rf_ui_text_length(buf), rf_ui_text_length(buf));
+            ui->edit_id = id;
+        }
+
+        if(click) {
+            uint32_t pos = _rf__ui_text_pos_at_x(ui, buf, 0, click_x);
+            rf_ui_text_select(buf, extend ? buf->anchor : pos, pos);
+        }
+
+        rf_UIEvent scratch[RF_MAX_UI_CONTROL + 1];
+        uint32_t count;
+        rf_UIEvent *events = _rf__ui_key_events(ui, scratch, &count);
+        int changed = 0;
+        for(uint32_t e = 0; e < count; ++e) {
+            // a 1-byte array only has room for the terminator
+            changed |= _rf__ui_text_key(buf, events + e, 0, max_chars ? max_chars - 1 : UINT32_MAX);
+        }
+        ui->controls[RF_UI_CONTROL_LEFT_PRESS] = 0;
+        ui->controls[RF_UI_CONTROL_RIGHT_PRESS] = 0;
+
+        if(changed) {
+            text[rf_ui_text_copy(buf, 0, rf_ui_text_length(buf), text)] = 0;
+        }
+
+        scroll = _rf__ui_scroll_to(scroll, _rf__ui_text_x_of(ui, buf, buf->cursor), 1, w);
+    }
+    else {
+        scroll = 0;
+        if(ui->edit_id == id) {
+            ui->edit_id = 0;
+        }
+    }
+    state->f[0] = scroll;
+
+    _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_LINE_EDIT, x, y, w, h);
+    if(ui->draw_list) {
+        rf_ui_push_clip(ui, x, y, w, h);
+        if(ui->active == id) {
+            _rf__ui_text_draw_line(ui, id, buf, 0, x - scroll, y, h);
+        }
         else {
-            if(_rf__ui_id_equ(ui->hot, id)) {
-                ui->hot = -1;
-            }
+            _rf__ui_draw_widget_text(ui, id, RF_UI_STYLE_TEXT, x, y, text, _rf__ui_strlen(text), 0);
+        }
+        rf_ui_pop_clip(ui);
+    }
+
+    _rf__ui_access_text(ui, node, text);
+    return text;
+}
+
+int rf_text_box(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, rf_UITextBuffer *buf) {
+    rf_UIWidgetState *state = rf_ui_get_state(ui, id);
+    float scroll_x = state->f[0],
+          scroll_y = state->f[1],
+          line_h = ui->line_height,
+          click_x = 0, click_y = 0;
+    int click = 0, extend = 0, changed = 0;
+
+    _rf__ui_add_focus(ui, id, x, y, w, h);
+    _rf__ui_access(ui, id, RF_UI_ROLE_TEXT_BOX, x, y, w, h, NULL);
+    if(_rf__ui_culled(ui, id, x, y, w, h)) {
+        return 0;
+    }
+
+    _rf__ui_hit_scroll(ui, id, x, y, w, h);
+    if(ui->scroll_hover == id) {
+        scroll_y -= ui->scroll_y;
+    }
+
+    if(ui->current_focus_id < 0) {
+        click = _rf__ui_text_mouse(ui, id, state, x, y, w, h, x - scroll_x, y - scroll_y, &click_x, &click_y, &extend);
+    }
+    else {
+        if(ui->hot == id) {
+            ui->active = id;
+        }
+    }
+
+    if(ui->active == id) {
+        if(click) {
+            float line = click_y / line_h;
+            uint32_t line_count = rf_ui_text_line_count(buf);
+            line = line < 0 ? 0 : line;
+            uint32_t pos = _rf__ui_text_pos_at_x(ui, buf, (uint32_t)line < line_count ? (uint32_t)line : line_count-1, click_x);
+            rf_ui_text_select(buf, extend ? buf->anchor : pos, pos);
+        }
+
+        rf_UIEvent scratch[RF_MAX_UI_CONTROL + 1];
+        uint32_t count;
+        rf_UIEvent *events = _rf__ui_key_events(ui, scratch, &count);
+        uint32_t old_cursor = buf->cursor;
+        for(uint32_t e = 0; e < count; ++e) {
+            changed |= _rf__ui_text_key(buf, events + e, 1, UINT32_MAX);
+        }
+        ui->controls[RF_UI_CONTROL_LEFT_PRESS] = 0;
+        ui->controls[RF_UI_CONTROL_RIGHT_PRESS] = 0;
+        ui->controls[RF_UI_CONTROL_UP_PRESS] = 0;
+        ui->controls[RF_UI_CONTROL_DOWN_PRESS] = 0;
+        ui->controls[RF_UI_CONTROL_ACTIVATE] = 0;
+
+        if(changed || click || buf->cursor != old_cursor) {
+            scroll_x = _rf__ui_scroll_to(scroll_x, _rf__ui_text_x_of(ui, buf, buf->cursor), 1, w);
+            scroll_y = _rf__ui_scroll_to(scroll_y, rf_ui_text_line_of(buf, buf->cursor) * line_h, line_h, h);
+        }
+    }
+
+    float max_scroll = rf_ui_text_line_count(buf) * line_h - h;
+    if(scroll_y > max_scroll) {
+        scroll_y = max_scroll;
+    }
+    if(scroll_y < 0) {
+        scroll_y = 0;
+    }
+    if(scroll_x < 0) {
+        scroll_x = 0;
+    }
+    state->f[0] = scroll_x;
+    state->f[1] = scroll_y;
+
+    _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_LINE_EDIT, x, y, w, h);
+    if(ui->draw_list && line_h > 0) {
+        // only the visible lines are looked at
+        uint32_t first = (uint32_t)(scroll_y / line_h),
+                 last = (uint32_t)((scroll_y + h) / line_h) + 1,
+                 line_count = rf_ui_text_line_count(buf);
+        if(last > line_count) {
+            last = line_count;
         }
+        rf_ui_push_clip(ui, x, y, w, h);
+        for(uint32_t line = first; line < last; ++line) {
+            _rf__ui_text_draw_line(ui, id, buf, line, x - scroll_x, y + line * line_h - scroll_y, line_h);
+        }
+        rf_ui_pop_clip(ui);
+    }
+
+    return changed;
+}
+
+// false for NaN and infinities, without needing math.h
+int _rf__ui_finite(float x) {
+    return x - x == 0;
+}
+
+// wheel scrolling (with momentum) and scrollbar dragging for a vertical
+// scroll area; the state's f[0] is the offset, f[1] where the thumb was
+// grabbed, and f[2] the velocity left over from the wheel
+float _rf__ui_scroll(rf_UIState *ui, rf_ui_id id, rf_UIWidgetState *state, float x, float y, float w, float h, float content_h) {
+    float scroll = state->f[0],
+          velocity = state->f[2];
+
+    _rf__ui_hit_scroll(ui, id, x, y, w, h);
+    if(ui->scroll_hover == id) {
+        velocity -= ui->scroll_y * (1 - RF_UI_SCROLL_FRICTION);
+    }
+    scroll += velocity;
+    velocity *= RF_UI_SCROLL_FRICTION;
+
+    rf_ui_id bar_id = rf_ui_hash("scrollbar", 9, id);
+    float thumb_h = content_h > h ? h * h / content_h : h;
+    if(thumb_h < RF_UI_SCROLLBAR_SIZE) {
+        thumb_h = RF_UI_SCROLLBAR_SIZE;
+    }
+    float max_scroll = content_h > h ? content_h - h : 0;
+
+    if(content_h > h) {
+        float bar_x = x + w - RF_UI_SCROLLBAR_SIZE;
+        float thumb_y = y + (max_scroll > 0 ? scroll / max_scroll : 0) * (h - thumb_h);
 
-        if(_rf__ui_id_equ(ui->hot, id)) {
+        if(ui->active == bar_id) {
             if(ui->controls[RF_UI_CONTROL_LEFT_MOUSE]) {
-                ui->active = id;
+                // a track no longer than the thumb has nowhere to drag it
+                if(h > thumb_h) {
+                    float t = (ui->cursor_y - state->f[1] - y) / (h - thumb_h);
+                    scroll = t * max_scroll;
+                }
+                velocity = 0;
+            }
+            else {
+                ui->active = 0;
             }
         }
+        else if(rf_ui_hit_rect(ui, bar_id, bar_x, y, RF_UI_SCROLLBAR_SIZE, h)) {
+            if(ui->controls[RF_UI_CONTROL_LEFT_MOUSE] && !ui->active) {
+                ui->active = bar_id;
+                if(ui->cursor_y >= thumb_y && ui->cursor_y <= thumb_y + thumb_h) {
+                    state->f[1] = ui->cursor_y - thumb_y;
+                }
+                else {
+                    state->f[1] = thumb_h / 2;
+                }
+            }
+        }
+    }
+
+    // a NaN would get past the clamps below and stick in the state
+    if(!_rf__ui_finite(scroll) || !_rf__ui_finite(velocity) || !_rf__ui_finite(max_scroll)) {
+        scroll = 0;
+        velocity = 0;
+    }
+    if(scroll > max_scroll) {
+        scroll = max_scroll;
+        velocity = 0;
+    }
+    if(scroll < 0) {
+        scroll = 0;
+        velocity = 0;
+    }
+    if(velocity > -0.1f && velocity < 0.1f) {
+        velocity = 0;
     }
     else {
-        if(_rf__ui_id_equ(ui->hot, id)) {
-            ui->active = id;
+        rf_ui_request_frame(ui);
+    }
+    state->f[0] = scroll;
+    state->f[2] = velocity;
+    return scroll;
+}
+
+void _rf__ui_draw_scrollbar(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float scroll, float content_h) {
+    if(content_h > h) {
+        rf_ui_id bar_id = rf_ui_hash("scrollbar", 9, id);
+        float thumb_h = h * h / content_h;
+        if(thumb_h < RF_UI_SCROLLBAR_SIZE) {
+            thumb_h = RF_UI_SCROLLBAR_SIZE;
         }
+        float thumb_y = y + scroll / (content_h - h) * (h - thumb_h);
+        _rf__ui_draw_widget_rect(ui, bar_id, RF_UI_STYLE_SCROLLBAR_TRACK, x + w - RF_UI_SCROLLBAR_SIZE, y, RF_UI_SCROLLBAR_SIZE, h);
+        _rf__ui_draw_widget_rect(ui, bar_id, RF_UI_STYLE_SCROLLBAR_THUMB, x + w - RF_UI_SCROLLBAR_SIZE, thumb_y, RF_UI_SCROLLBAR_SIZE, thumb_h);
+    }
+}
+
+int rf_ui_list_begin(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, uint32_t row_count, float row_h, rf_UIListView *view) {
+    rf_UIWidgetState *state = rf_ui_get_state(ui, id);
+    float content_h = row_count * row_h;
+    float bar_w = content_h > h ? RF_UI_SCROLLBAR_SIZE : 0;
+    float scroll = _rf__ui_scroll(ui, id, state, x, y, w, h, content_h);
+
+    view->id = id;
+    view->x = x;
+    view->y = y;
+    view->w = w - bar_w;
+    view->h = h;
+    view->row_h = row_h;
+    view->row_count = row_count;
+    view->scroll = scroll;
+    view->column_count = 0;
+    view->column_widths = NULL;
+
+    if(row_h > 0) {
+        view->first = (uint32_t)(scroll / row_h);
+        view->last = (uint32_t)((scroll + h) / row_h) + 1;
     }
+    else {
+        view->first = view->last = 0;
+    }
+    if(view->first > row_count) {
+        view->first = row_count;
+    }
+    if(view->last > row_count) {
+        view->last = row_count;
+    }
+
+    _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_LIST, x, y, w - bar_w, h);
+    _rf__ui_draw_scrollbar(ui, id, x, y, w, h, scroll, content_h);
+
+    uint32_t node = _rf__ui_access(ui, id, RF_UI_ROLE_LIST, x, y, w, h, NULL);
+    _rf__ui_access_value(ui, node, scroll);
+    _rf__ui_access_push(ui, node);
+    rf_ui_push_clip(ui, x, y, w - bar_w, h);
+    rf_ui_push_id(ui, id);
+
+    return view->first < view->last;
+}
 
-    if(_rf__ui_id_equ(ui->active, id)) {
-        if(ui->char_input && text_len < max_chars-1) {
-            text[text_len++] = ui->char_input;
+rf_UIRect rf_ui_list_row(rf_UIState *ui, rf_UIListView *view, uint32_t row) {
+    (void)ui;
+    return rf_ui_rect(view->x, view->y + row * view->row_h - view->scroll, view->w, view->row_h);
+}
+
+void rf_ui_list_end(rf_UIState *ui, rf_UIListView *view) {
+    (void)view;
+    rf_ui_pop_id(ui);
+    rf_ui_pop_clip(ui);
+    _rf__ui_access_pop(ui);
+}
+
+int rf_ui_table_begin(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, uint32_t row_count, float row_h,
+                      uint32_t column_count, const float *column_widths, rf_UIListView *view) {
+    int visible = rf_ui_list_begin(ui, id, x, y, w, h, row_count, row_h, view);
+    view->column_count = column_count;
+    view->column_widths = column_widths;
+    return visible;
+}
+
+rf_UIRect rf_ui_table_cell(rf_UIState *ui, rf_UIListView *view, uint32_t row, uint32_t column) {
+    rf_UIRect rect = rf_ui_list_row(ui, view, row);
+    if(view->column_count) {
+        if(view->column_widths) {
+            for(uint32_t i = 0; i < column && i < view->column_count; ++i) {
+                rect.x += view->column_widths[i];
+            }
+            rect.w = column < view->column_count ? view->column_widths[column] : 0;
         }
-        if(ui->controls[RF_UI_CONTROL_BACKSPACE] && text_len > 0) {
-            text[--text_len] = 0;
+        else {
+            rect.w = view->w / view->column_count;
+            rect.x += column * rect.w;
         }
     }
+    return rect;
+}
 
-    return text;
+void rf_ui_table_end(rf_UIState *ui, rf_UIListView *view) {
+    rf_ui_list_end(ui, view);
+}
+
+void rf_ui_scroll_begin(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h, float content_h, rf_UIScrollView *view) {
+    rf_UIWidgetState *state = rf_ui_get_state(ui, id);
+    rf_ui_id content_id = rf_ui_hash("content", 7, id);
+
+    // with no content height given, use what the content took up last frame
+    if(content_h <= 0) {
+        rf_UIWidgetState *content = rf_ui_find_state(ui, content_id);
+        content_h = content ? content->f[2] + 2*ui->layout_padding : 0;
+    }
+
+    float bar_w = content_h > h ? RF_UI_SCROLLBAR_SIZE : 0;
+    float scroll = _rf__ui_scroll(ui, id, state, x, y, w, h, content_h);
+
+    view->id = id;
+    view->x = x;
+    view->y = y;
+    view->w = w - bar_w;
+    view->h = h;
+    view->scroll = scroll;
+    view->content_h = content_h;
+
+    _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_LIST, x, y, w - bar_w, h);
+    _rf__ui_draw_scrollbar(ui, id, x, y, w, h, scroll, content_h);
+
+    uint32_t node = _rf__ui_access(ui, id, RF_UI_ROLE_SCROLL_REGION, x, y, w, h, NULL);
+    _rf__ui_access_value(ui, node, scroll);
+    _rf__ui_access_push(ui, node);
+    rf_ui_push_clip(ui, x, y, w - bar_w, h);
+    rf_ui_push_id(ui, id);
+    rf_ui_layout_begin(ui, content_id, RF_UI_LAYOUT_COLUMN,
+                       rf_ui_rect(x, y - scroll, w - bar_w, content_h > h ? content_h : h));
+}
+
+void rf_ui_scroll_end(rf_UIState *ui, rf_UIScrollView *view) {
+    (void)view;
+    rf_ui_layout_pop(ui);
+    rf_ui_pop_id(ui);
+    rf_ui_pop_clip(ui);
+    _rf__ui_access_pop(ui);
+}
+
+int _rf__ui_tree_find(rf_UIState *ui, rf_ui_id id, uint32_t *slot) {
+    uint32_t mask = ui->tree_open_cap - 1;
+    for(*slot = (uint32_t)id & mask; ui->tree_open[*slot]; *slot = (*slot + 1) & mask) {
+        if(ui->tree_open[*slot] == id) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int rf_ui_tree_is_open(rf_UIState *ui, rf_ui_id id) {
+    uint32_t slot;
+    return ui->tree_open_cap && _rf__ui_tree_find(ui, id, &slot);
+}
+
+void rf_ui_tree_set_open(rf_UIState *ui, rf_ui_id id, int open) {
+    uint32_t slot;
+    if(open) {
+        if((ui->tree_open_count + 1) * 2 > ui->tree_open_cap) {
+            rf_ui_id *old = ui->tree_open;
+            uint32_t old_cap = ui->tree_open_cap;
+            ui->tree_open_cap = old_cap ? old_cap * 2 : _RF_UI_ARRAY_START_CAP;
+            ui->tree_open = (rf_ui_id *)RF_UI_REALLOC(NULL, ui->tree_open_cap * sizeof(rf_ui_id));
+            for(uint32_t i = 0; i < ui->tree_open_cap; ++i) {
+                ui->tree_open[i] = 0;
+            }
+            for(uint32_t i = 0; i < old_cap; ++i) {
+                if(old[i]) {
+                    _rf__ui_tree_find(ui, old[i], &slot);
+                    ui->tree_open[slot] = old[i];
+                }
+            }
+            RF_UI_FREE(old);
+        }
+        if(!_rf__ui_tree_find(ui, id, &slot)) {
+            ui->tree_open[slot] = id;
+            ++ui->tree_open_count;
+        }
+    }
+    else if(ui->tree_open_cap && _rf__ui_tree_find(ui, id, &slot)) {
+        uint32_t mask = ui->tree_open_cap - 1;
+        uint32_t hole = slot;
+        for(uint32_t i = (slot + 1) & mask; ui->tree_open[i]; i = (i + 1) & mask) {
+            uint32_t home = (uint32_t)ui->tree_open[i] & mask;
+            if(((i - home) & mask) >= ((i - hole) & mask)) {
+                ui->tree_open[hole] = ui->tree_open[i];
+                hole = i;
+            }
+        }
+        ui->tree_open[hole] = 0;
+        --ui->tree_open_count;
+    }
+}
+
+rf_UILayout *_rf__ui_tree_layout(rf_UIState *ui) {
+    if(!ui->layout_stack_size || ui->layout_overflow ||
+       ui->layout_stack[ui->layout_stack_size-1].direction != RF_UI_LAYOUT_COLUMN) {
+        return NULL;
+    }
+    return ui->layout_stack + ui->layout_stack_size - 1;
+}
+
+// lays out, handles and draws one indented row; returns 1 if it was clicked
+int _rf__ui_tree_row(rf_UIState *ui, rf_ui_id id, const char *label, const char *mark, uint32_t *node) {
+    rf_UIRect r = rf_ui_layout_next(ui, rf_ui_pixels(ui->line_height));
+    float indent = ui->tree_depth * RF_UI_TREE_INDENT;
+    r.x += indent;
+    r.w = r.w > indent ? r.w - indent : 0;
+
+    _rf__ui_add_focus(ui, id, r.x, r.y, r.w, r.h);
+    *node = _rf__ui_access(ui, id, mark ? RF_UI_ROLE_TREE_NODE : RF_UI_ROLE_TREE_LEAF, r.x, r.y, r.w, r.h, label);
+    if(_rf__ui_culled(ui, id, r.x, r.y, r.w, r.h)) {
+        return 0;
+    }
+
+    int clicked = _rf__ui_button_behavior(ui, id, r.x, r.y, r.w, r.h);
+    _rf__ui_access_value(ui, *node, (float)clicked);
+    _rf__ui_draw_widget_rect(ui, id, RF_UI_STYLE_TREE_NODE, r.x, r.y, r.w, r.h);
+    if(mark) {
+        _rf__ui_draw_widget_text(ui, id, RF_UI_STYLE_TEXT, r.x, r.y, mark, 1, 0);
+    }
+    _rf__ui_draw_widget_text(ui, id, RF_UI_STYLE_TEXT, r.x + RF_UI_TREE_INDENT, r.y,
+                             label, _rf__ui_strlen((char *)label), 0);
+    return clicked;
+}
+
+int rf_ui_tree_push(rf_UIState *ui, rf_ui_id id, const char *label) {
+    if(ui->tree_depth >= RF_UI_TREE_STACK_SIZE) {
+        return 0;
+    }
+
+    int open = rf_ui_tree_is_open(ui, id);
+    uint32_t node;
+    if(_rf__ui_tree_row(ui, id, label, open ? "-" : "+", &node)) {
+        open = !open;
+        rf_ui_tree_set_open(ui, id, open);
+    }
+    if(!open) {
+        return 0;
+    }
+    _rf__ui_access_flags(ui, node, RF_UI_ACCESS_EXPANDED);
+
+    rf_UIWidgetState *state = rf_ui_get_state(ui, id);
+    rf_UILayout *layout = _rf__ui_tree_layout(ui);
+    rf_ui_id owner = (rf_ui_id)(uint32_t)state->i[2] | (rf_ui_id)(uint32_t)state->i[3] << 32;
+
+    // an open subtree that was measured before and is entirely outside the
+    // clip rectangle is skipped: the layout moves past it as if its children
+    // had been submitted. Not while keyboard navigation is counting on the
+    // focus list, or while one of its widgets is active
+    if(layout && state->i[0] && ui->clip_stack_size && ui->current_focus_id < 0 &&
+       (!ui->active || ui->active != owner)) {
+        float *clip = ui->clip_stack[ui->clip_stack_size-1];
+        float y = layout->y + layout->cursor;
+        if(y > clip[1] + clip[3] || y + state->f[0] < clip[1]) {
+            layout->cursor += state->f[0];
+            layout->fixed_total += state->f[1];
+            layout->child_count += (uint32_t)state->i[1];
+            return 0;
+        }
+    }
+
+    rf_UITreeLevel *level = ui->tree_stack + ui->tree_depth++;
+    level->id = id;
+    level->active = ui->active;
+    level->layout_depth = layout ? ui->layout_stack_size : 0;
+    level->cursor = layout ? layout->cursor : 0;
+    level->fixed_total = layout ? layout->fixed_total : 0;
+    level->child_count = layout ? layout->child_count : 0;
+    rf_ui_push_id(ui, id);
+    _rf__ui_access_push(ui, node);
+    return 1;
+}
+
+void rf_ui_tree_pop(rf_UIState *ui) {
+    if(!ui->tree_depth) {
+        return;
+    }
+
+    rf_UITreeLevel *level = ui->tree_stack + --ui->tree_depth;
+    rf_ui_pop_id(ui);
+    _rf__ui_access_pop(ui);
+
+    rf_UIWidgetState *state = rf_ui_get_state(ui, level->id);
+    rf_UILayout *layout = _rf__ui_tree_layout(ui);
+    if(layout && level->layout_depth == ui->layout_stack_size) {
+        state->f[0] = layout->cursor - level->cursor;
+        state->f[1] = layout->fixed_total - level->fixed_total;
+        state->i[0] = 1;
+        state->i[1] = (int32_t)(layout->child_count - level->child_count);
+    }
+    else {
+        state->i[0] = 0;
+    }
+
+    // remember which widget became active inside the subtree, so it isn't
+    // skipped while that widget is being dragged
+    if(ui->active != level->active) {
+        state->i[2] = (int32_t)(uint32_t)ui->active;
+        state->i[3] = (int32_t)(uint32_t)(ui->active >> 32);
+    }
+}
+
+int rf_ui_tree_leaf(rf_UIState *ui, rf_ui_id id, const char *label) {
+    uint32_t node;
+    return _rf__ui_tree_row(ui, id, label, NULL, &node);
+}
+
+rf_UIDock *_rf__ui_find_dock(rf_UIState *ui, rf_ui_id id) {
+    for(uint32_t i = 0; i < ui->dock_count; ++i) {
+        if(ui->docks[i].id == id) {
+            return ui->docks + i;
+        }
+    }
+    return NULL;
+}
+
+rf_UIDock *_rf__ui_dock_at(rf_UIState *ui, float x, float y) {
+    for(uint32_t i = ui->dock_count; i > 0; --i) {
+        rf_UIDock *dock = ui->docks + i - 1;
+        if(_rf__ui_point_over(x, y, dock->x, dock->y, dock->w, dock->h)) {
+            return dock;
+        }
+    }
+    return NULL;
+}
+
+void rf_ui_dock_space(rf_UIState *ui, rf_ui_id id, float x, float y, float w, float h) {
+    rf_UIWidgetState *state = rf_ui_get_state(ui, id);
+
+    ui->docks = (rf_UIDock *)_rf__ui_grow(ui->docks, &ui->dock_cap, sizeof(rf_UIDock), ui->dock_count + 1);
+    rf_UIDock *dock = ui->docks + ui->dock_count++;
+    dock->id = id;
+    dock->x = x;
+    dock->y = y;
+    dock->w = w;
+    dock->h = h;
+    dock->tab_cursor = 0;
+    dock->selected = (rf_ui_id)(uint32_t)state->i[0] | (rf_ui_id)(uint32_t)state->i[1] << 32;
+    dock->next_selected = 0;
+    dock->first_tab = 0;
+    dock->selected_seen = 0;
+
+    rf_ui_hit_rect(ui, id, x, y, w, h);
+    _rf__ui_access(ui, id, RF_UI_ROLE_DOCK_SPACE, x, y, w, h, NULL);
+    _rf__ui_draw_widget_rect(ui, 0, RF_UI_STYLE_WINDOW, x, y, w, h);
+    _rf__ui_draw_widget_rect(ui, 0, RF_UI_STYLE_TAB, x, y, w, ui->line_height + ui->layout_padding);
+}
+
+void _rf__ui_set_dock_id(rf_UIState *ui, rf_ui_id window_id, rf_ui_id dock_id) {
+    rf_UIWidgetState *state = rf_ui_get_state(ui, rf_ui_hash("dock", 4, window_id));
+    state->i[0] = (int32_t)(uint32_t)dock_id;
+    state->i[1] = (int32_t)(uint32_t)(dock_id >> 32);
+}
+
+void _rf__ui_window_content(rf_UIState *ui, rf_UIWindow *window) {
+    rf_ui_push_clip(ui, window->x, window->y, window->w, window->h);
+    rf_ui_push_id(ui, window->id);
+    rf_ui_layout_begin(ui, rf_ui_hash("content", 7, window->id), RF_UI_LAYOUT_COLUMN,
+                       rf_ui_rect(window->x, window->y, window->w, window->h));
+}
+
+int rf_ui_window_begin(rf_UIState *ui, rf_ui_id id, const char *title, float x, float y, float w, float h,
+                       int *open, rf_UIWindow *window) {
+    rf_UIWidgetState *state = rf_ui_get_state(ui, rf_ui_hash("dock", 4, id));
+    rf_ui_id dock_id = (rf_ui_id)(uint32_t)state->i[0] | (rf_ui_id)(uint32_t)state->i[1] << 32;
+
+    state = rf_ui_get_state(ui, id);
+    if(!(state->i[0] & _RF_UI_WINDOW_PLACED)) {
+        state->f[0] = x;
+        state->f[1] = y;
+        state->f[2] = w;
+        state->f[3] = h;
+        state->i[0] |= _RF_UI_WINDOW_PLACED;
+        state->i[1] = ++ui->window_z;
+    }
+    float wx = state->f[0],
+          wy = state->f[1],
+          ww = state->f[2],
+          wh = state->f[3];
+    int32_t flags = state->i[0],
+            z = state->i[1],
+            rank = state->i[2];
+
+    window->id = id;
+    window->dock = 0;
+    window->record = 0;
+    window->floating = 0;
+
+    // a hidden window keeps its place, but skips everything else
+    if(open && !*open) {
+        return 0;
+    }
+
+    uint32_t title_len = _rf__ui_strlen((char *)title);
+    float bar_h = ui->line_height + ui->layout_padding;
+    rf_UIDock *dock = dock_id ? _rf__ui_find_dock(ui, dock_id) : NULL;
+    float tab_x = 0,
+          tab_w = 0;
+
+    if(dock) {
+        rf_ui_id tab_id = rf_ui_hash("tab", 3, id);
+        tab_x = dock->x + dock->tab_cursor;
+        tab_w = _rf__ui_text_width(ui, title, title_len) + 2*ui->layout_padding;
+        dock->tab_cursor += tab_w;
+        if(!dock->first_tab) {
+            dock->first_tab = id;
+        }
+        if(!dock->selected) {
+            dock->selected = id;
+        }
+
+        if(rf_ui_hit_rect(ui, tab_id, tab_x, dock->y, tab_w, bar_h) &&
+           ui->controls[RF_UI_CONTROL_LEFT_MOUSE] && !ui->active) {
+            ui->active = tab_id;
+            ui->window_drag_x = ui->cursor_x - tab_x;
+            ui->window_drag_y = ui->cursor_y - dock->y;
+            dock->selected = id;
+        }
+        if(ui->active == tab_id) {
+            if(!ui->controls[RF_UI_CONTROL_LEFT_MOUSE]) {
+                ui->active = 0;
+            }
+            else if(ui->cursor_y < dock->y - bar_h || ui->cursor_y > dock->y + 2*bar_h) {
+                // dragged out of the tab bar: float it, and keep dragging it by its title
+                _rf__ui_set_dock_id(ui, id, 0);
+                wx = ui->cursor_x - ui->window_drag_x;
+                wy = ui->cursor_y - ui->window_drag_y;
+                z = ++ui->window_z;
+                ui->active = rf_ui_hash("title", 5, id);
+                dock = NULL;
+            }
+        }
+    }
+
+    if(dock) {
+        int selected = dock->selected == id;
+        uint32_t node = _rf__ui_access(ui, id, RF_UI_ROLE_WINDOW, tab_x, dock->y, tab_w, bar_h, title);
+        _rf__ui_draw_widget_rect(ui, 0, selected ? RF_UI_STYLE_WINDOW_TITLE : RF_UI_STYLE_TAB,
+                                 tab_x, dock->y, tab_w, bar_h);
+        _rf__ui_draw_widget_text(ui, 0, RF_UI_STYLE_TEXT, tab_x + ui->layout_padding, dock->y + ui->layout_padding / 2,
+                                 title, title_len, 0);
+
+        // only the selected tab's content is built
+        if(!selected) {
+            return 0;
+        }
+        dock->selected_seen = 1;
+
+        window->dock = dock->id;
+        window->x = dock->x;
+        window->y = dock->y + bar_h;
+        window->w = dock->w;
+        window->h = dock->h > bar_h ? dock->h - bar_h : 0;
+        _rf__ui_access_flags(ui, node, RF_UI_ACCESS_EXPANDED);
+        _rf__ui_access_push(ui, node);
+        _rf__ui_window_content(ui, window);
+        return 1;
+    }
+
+    rf_ui_id title_id = rf_ui_hash("title", 5, id),
+             collapse_id = rf_ui_hash("collapse", 8, id),
+             close_id = rf_ui_hash("close", 5, id),
+             resize_id = rf_ui_hash("resize", 6, id);
+    int collapsed = (flags & _RF_UI_WINDOW_COLLAPSED) != 0;
+
+    // pressing anywhere on the topmost window under the cursor raises it
+    if(ui->window_hover == id && ui->controls[RF_UI_CONTROL_LEFT_MOUSE] && !ui->active && z != ui->window_z) {
+        z = ++ui->window_z;
+    }
+
+    rf_ui_push_layer(ui, ui->layer + 1 + rank);
+    float full_h = collapsed ? bar_h : wh;
+    if(_rf__ui_cursor_over(ui, wx, wy, ww, full_h) && _rf__ui_cursor_in_clip(ui) &&
+       (!ui->window_hit_id || ui->layer >= ui->window_hit_layer)) {
+        ui->window_hit_id = id;
+        ui->window_hit_layer = ui->layer;
+    }
+
+    if(!collapsed) {
+        rf_ui_hit_rect(ui, id, wx, wy + bar_h, ww, wh - bar_h);
+    }
+    if(rf_ui_hit_rect(ui, title_id, wx, wy, ww, bar_h) && ui->controls[RF_UI_CONTROL_LEFT_MOUSE] && !ui->active) {
+        ui->active = title_id;
+        ui->window_drag_x = ui->cursor_x - wx;
+        ui->window_drag_y = ui->cursor_y - wy;
+    }
+    if(_rf__ui_button_behavior(ui, collapse_id, wx, wy, bar_h, bar_h)) {
+        collapsed = !collapsed;
+    }
+    if(open && _rf__ui_button_behavior(ui, close_id, wx + ww - bar_h, wy, bar_h, bar_h)) {
+        *open = 0;
+    }
+
+    rf_UIDock *target = NULL;
+    if(ui->active == title_id) {
+        target = _rf__ui_dock_at(ui, ui->cursor_x, ui->cursor_y);
+        if(ui->controls[RF_UI_CONTROL_LEFT_MOUSE]) {
+            wx = ui->cursor_x - ui->window_drag_x;
+            wy = ui->cursor_y - ui->window_drag_y;
+        }
+        else {
+            ui->active = 0;
+            if(target) {
+                _rf__ui_set_dock_id(ui, id, target->id);
+                target->next_selected = id;
+                rf_ui_request_frame(ui);
+            }
+            target = NULL;
+        }
+    }
+
+    if(!collapsed) {
+        float grip = RF_UI_SCROLLBAR_SIZE;
+        if(rf_ui_hit_rect(ui, resize_id, wx + ww - grip, wy + wh - grip, grip, grip) &&
+           ui->controls[RF_UI_CONTROL_LEFT_MOUSE] && !ui->active) {
+            ui->active = resize_id;
+            ui->window_drag_x = ui->cursor_x - (wx + ww);
+            ui->window_drag_y = ui->cursor_y - (wy + wh);
+        }
+        if(ui->active == resize_id) {
+            if(ui->controls[RF_UI_CONTROL_LEFT_MOUSE]) {
+                ww = ui->cursor_x - ui->window_drag_x - wx;
+                wh = ui->cursor_y - ui->window_drag_y - wy;
+                ww = ww > 2*bar_h ? ww : 2*bar_h;
+                wh = wh > 2*bar_h ? wh : 2*bar_h;
+            }
+            else {
+                ui->active = 0;
+            }
+        }
+    }
+
+    state = rf_ui_get_state(ui, id);
+    state->f[0] = wx;
+    state->f[1] = wy;
+    state->f[2] = ww;
+    state->f[3] = wh;
+    state->i[0] = collapsed ? flags | _RF_UI_WINDOW_COLLAPSED : flags & ~_RF_UI_WINDOW_COLLAPSED;
+    state->i[1] = z;
+    uint32_t node = _rf__ui_access(ui, id, RF_UI_ROLE_WINDOW, wx, wy, ww, bar_h, title);
+
+    // top-level windows are drawn in z order: rf_ui_end moves their commands
+    if(!ui->window_depth) {
+        ui->windows = (rf_UIWindowRecord *)_rf__ui_grow(ui->windows, &ui->window_cap, sizeof(rf_UIWindowRecord),
+                                                        ui->window_count + 1);
+        rf_UIWindowRecord *record = ui->windows + ui->window_count++;
+        record->id = id;
+        record->z = z;
+        record->rank = rank;
+        record->rect = rf_ui_rect(wx, wy, ww, collapsed ? bar_h : wh);
+        record->command_start = record->command_end = ui->draw_list ? ui->draw_list->command_count : 0;
+        window->record = ui->window_count;
+    }
+
+    if(!collapsed) {
+        _rf__ui_draw_widget_rect(ui, 0, RF_UI_STYLE_WINDOW, wx, wy, ww, wh);
+    }
+    _rf__ui_draw_widget_rect(ui, title_id, RF_UI_STYLE_WINDOW_TITLE, wx, wy, ww, bar_h);
+    _rf__ui_draw_widget_text(ui, collapse_id, RF_UI_STYLE_TEXT, wx + ui->layout_padding, wy + ui->layout_padding / 2,
+                             collapsed ? "+" : "-", 1, 0);
+    _rf__ui_draw_widget_text(ui, title_id, RF_UI_STYLE_TEXT, wx + bar_h, wy + ui->layout_padding / 2, title, title_len, 0);
+    if(open) {
+        _rf__ui_draw_widget_text(ui, close_id, RF_UI_STYLE_TEXT, wx + ww - bar_h + ui->layout_padding,
+                                 wy + ui->layout_padding / 2, "x", 1, 0);
+    }
+    if(target) {
+        _rf__ui_draw_widget_rect(ui, 0, RF_UI_STYLE_DOCK_PREVIEW, target->x, target->y, target->w, target->h);
+    }
+
+    if(collapsed) {
+        if(window->record) {
+            ui->windows[window->record-1].command_end = ui->draw_list ? ui->draw_list->command_count : 0;
+        }
+        rf_ui_pop_layer(ui);
+        return 0;
+    }
+
+    _rf__ui_draw_widget_rect(ui, resize_id, RF_UI_STYLE_SCROLLBAR_THUMB, wx + ww - RF_UI_SCROLLBAR_SIZE,
+                             wy + wh - RF_UI_SCROLLBAR_SIZE, RF_UI_SCROLLBAR_SIZE, RF_UI_SCROLLBAR_SIZE);
+
+    window->floating = 1;
+    window->x = wx;
+    window->y = wy + bar_h;
+    window->w = ww;
+    window->h = wh > bar_h ? wh - bar_h : 0;
+    ++ui->window_depth;
+    _rf__ui_access_flags(ui, node, RF_UI_ACCESS_EXPANDED);
+    _rf__ui_access_push(ui, node);
+    _rf__ui_window_content(ui, window);
+    return 1;
+}
+
+void rf_ui_window_end(rf_UIState *ui, rf_UIWindow *window) {
+    rf_ui_layout_pop(ui);
+    rf_ui_pop_id(ui);
+    rf_ui_pop_clip(ui);
+    _rf__ui_access_pop(ui);
+    if(window->floating) {
+        --ui->window_depth;
+        if(window->record) {
+            ui->windows[window->record-1].command_end = ui->draw_list ? ui->draw_list->command_count : 0;
+        }
+        rf_ui_pop_layer(ui);
+    }
+}
+
+// settles which tab each dock space shows, ranks the floating windows by
+// when they were last raised, and moves their draw commands into that order
+void _rf__ui_end_windows(rf_UIState *ui) {
+    for(uint32_t i = 0; i < ui->dock_count; ++i) {
+        rf_UIDock *dock = ui->docks + i;
+        rf_ui_id selected = dock->next_selected ? dock->next_selected :
+                            dock->selected_seen ? dock->selected : dock->first_tab;
+        if(selected != dock->selected) {
+            rf_ui_request_frame(ui);
+        }
+        rf_UIWidgetState *state = rf_ui_get_state(ui, dock->id);
+        state->i[0] = (int32_t)(uint32_t)selected;
+        state->i[1] = (int32_t)(uint32_t)(selected >> 32);
+    }
+    ui->window_hover = ui->window_hit_id;
+
+    uint32_t count = ui->window_count;
+    if(!count) {
+        return;
+    }
+
+    rf_UIDrawList *list = ui->draw_list;
+    int in_order = 1;
+    for(uint32_t i = 1; i < count; ++i) {
+        if(ui->windows[i].z < ui->windows[i-1].z ||
+           ui->windows[i].command_start != ui->windows[i-1].command_end) {
+            in_order = 0;
+        }
+    }
+    if(list && ui->windows[count-1].command_end != list->command_count) {
+        in_order = 0;
+    }
+
+    if(list && !in_order) {
+        ui->window_commands = (rf_UICommand *)_rf__ui_grow(ui->window_commands, &ui->window_command_cap,
+                                                           sizeof(rf_UICommand), list->command_count);
+        for(uint32_t i = 0; i < list->command_count; ++i) {
+            ui->window_commands[i] = list->commands[i];
+        }
+
+        // everything outside windows first, in the order it was submitted
+        uint32_t out = 0,
+                 from = 0;
+        for(uint32_t w = 0; w <= count; ++w) {
+            uint32_t to = w < count ? ui->windows[w].command_start : list->command_count;
+            for(uint32_t i = from; i < to; ++i) {
+                list->commands[out++] = ui->window_commands[i];
+            }
+            from = w < count ? ui->windows[w].command_end : to;
+        }
+    }
+
+    for(uint32_t i = 1; i < count; ++i) {
+        rf_UIWindowRecord record = ui->windows[i];
+        uint32_t j = i;
+        for(; j > 0 && ui->windows[j-1].z > record.z; --j) {
+            ui->windows[j] = ui->windows[j-1];
+        }
+        ui->windows[j] = record;
+    }
+
+    uint32_t out = list ? list->command_count : 0;
+    for(uint32_t w = count; w > 0; --w) {
+        out -= ui->windows[w-1].command_end - ui->windows[w-1].command_start;
+    }
+    for(uint32_t w = 0; w < count; ++w) {
+        rf_UIWindowRecord *record = ui->windows + w;
+        if(list && !in_order) {
+            for(uint32_t i = record->command_start; i < record->command_end; ++i) {
+                list->commands[out++] = ui->window_commands[i];
+            }
+        }
+        rf_UIWidgetState *state = rf_ui_find_state(ui, record->id);
+        if(state) {
+            state->i[2] = (int32_t)w;
+        }
+        if(record->rank != (int32_t)w) {
+            rf_ui_request_frame(ui);
+        }
+    }
+}
+
+// reordering windows doesn't change any command, so it can't show up in the
+// draw list diff
+void _rf__ui_damage_windows(rf_UIState *ui) {
+    for(uint32_t w = 0; w < ui->window_count; ++w) {
+        if(ui->windows[w].rank != (int32_t)w) {
+            _rf__ui_add_damage(ui->draw_list, ui->windows[w].rect);
+        }
+    }
 }
 
 #endif /* RF_UI_IMPLEMENTATION */